@@ -33,7 +33,10 @@ typedef enum {
     PMCR_EL0 = 1,
     PMCCNTR_EL0,
     PMCCFILTR_EL0,
-    PMCNTENSET_EL0
+    PMCNTENSET_EL0,
+    PMCNTENCLR_EL0,
+    PMEVTYPER0_EL0,
+    PMEVCNTR0_EL0
 } PAL_PMU_REGS;
 
 UINT64 pal_pmu_reg_read(UINT32 RegId);
@@ -49,6 +52,11 @@ VOID Arm64WritePmcr(UINT64 WriteData);
 VOID Arm64WritePmccntr(UINT64 WriteData);
 VOID Arm64WritePmccfiltr(UINT64 WriteData);
 VOID Arm64WritePmcntenset(UINT64 WriteData);
+UINT64 Arm64ReadPmevcntr0(VOID);
+UINT64 Arm64ReadPmevtyper0(VOID);
+VOID Arm64WritePmevcntr0(UINT64 WriteData);
+VOID Arm64WritePmevtyper0(UINT64 WriteData);
+VOID Arm64WritePmcntenclr(UINT64 WriteData);
 
 #endif
 
@@ -51,9 +51,13 @@ UINT64 pal_get_pptt_ptr();
 UINT64 pal_get_mpam_ptr();
 UINT64 pal_get_madt_ptr();
 UINT64 pal_get_srat_ptr();
+UINT64 pal_acpi_get_table(UINT32 Signature, UINT32 Instance);
 EFI_STATUS   pal_get_srat_info();
 
 extern VOID* g_acs_log_file_handle;
+extern VOID* g_acs_checkpoint_file_handle;
+extern VOID* g_acs_results_file_handle;
+extern VOID* g_acs_samples_file_handle;
 extern UINT32 g_print_level;
 
 /* Only Errors. Use this to de-clutter the terminal and focus only on specifics */
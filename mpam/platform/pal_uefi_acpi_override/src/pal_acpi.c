@@ -57,35 +57,202 @@ pal_get_xsdt_ptr (
   }
 }
 
+/* Tables indexed by signature, the slots are open addressed. XSDT entries
+ * past ACPI_INDEX_MAX_TABLES are not indexed and are searched on lookup.
+ */
+#define ACPI_INDEX_MAX_TABLES   64
+#define ACPI_INDEX_SLOT_SHIFT   7
+#define ACPI_INDEX_SLOTS        (1 << ACPI_INDEX_SLOT_SHIFT)
+
+typedef struct {
+  UINT32  Signature;
+  UINT32  Count;      /* Instances of the signature */
+  UINT32  First;      /* First instance in gAcpiTables */
+} ACPI_INDEX_SLOT;
+
+STATIC ACPI_INDEX_SLOT gAcpiIndex[ACPI_INDEX_SLOTS];
+STATIC UINT64          gAcpiTables[ACPI_INDEX_MAX_TABLES];
+STATIC BOOLEAN         gAcpiIndexCreated;
+STATIC UINT64          *gAcpiEntry64;
+STATIC UINT32          gAcpiEntry64Num;
+
 /**
- * @brief   Iterate through the tables pointed by XSDT and return MADT address
+ * @brief   Return the index slot of a signature, or the free slot it would take
+ * @param   Signature  ACPI table signature
+ * @return  Index slot
+ */
+STATIC
+ACPI_INDEX_SLOT *
+pal_acpi_index_slot (
+    UINT32 Signature
+  )
+{
+  UINT32  Slot;
+
+  Slot = (Signature * 0x9E3779B1) >> (32 - ACPI_INDEX_SLOT_SHIFT);
+  while (gAcpiIndex[Slot].Signature != 0 && gAcpiIndex[Slot].Signature != Signature) {
+    Slot = (Slot + 1) & (ACPI_INDEX_SLOTS - 1);
+  }
+
+  return &gAcpiIndex[Slot];
+}
+
+/**
+ * @brief   Walk the XSDT once and index every table by signature. The instances
+ *          of a signature are kept in XSDT order. Checksums are verified here,
+ *          a table with a bad checksum is reported and still indexed.
  * @param   None
- * @return  64-bit MADT address
+ * @return  None
  */
-UINT64
-pal_get_madt_ptr (
+VOID
+pal_acpi_index_create (
     VOID
   )
 {
-
   EFI_ACPI_DESCRIPTION_HEADER   *Xsdt;
+  EFI_ACPI_DESCRIPTION_HEADER   *Table;
+  ACPI_INDEX_SLOT               *Slot;
   UINT64                        *Entry64;
   UINT32                        Entry64Num;
   UINT32                        Idx;
+  UINT32                        Next;
+
+  gAcpiIndexCreated = TRUE;
+  gAcpiEntry64Num = 0;
+  SetMem (gAcpiIndex, sizeof (gAcpiIndex), 0);
 
   Xsdt = (EFI_ACPI_DESCRIPTION_HEADER *) pal_get_xsdt_ptr();
   if (Xsdt == NULL) {
     acs_print(ACS_PRINT_ERR, L"XSDT not found \n");
-    return 0;
+    return;
+  }
+  if (CalculateSum8 ((UINT8 *)Xsdt, Xsdt->Length)) {
+    acs_print(ACS_PRINT_WARN, L"XSDT checksum is invalid \n");
   }
 
   Entry64  = (UINT64 *)(Xsdt + 1);
   Entry64Num = (Xsdt->Length - sizeof(EFI_ACPI_DESCRIPTION_HEADER)) >> 3;
+  gAcpiEntry64 = Entry64;
+  gAcpiEntry64Num = Entry64Num;
+  if (Entry64Num > ACPI_INDEX_MAX_TABLES) {
+    acs_print(ACS_PRINT_INFO, L"Indexing the first %d of %d ACPI tables \n",
+              ACPI_INDEX_MAX_TABLES, Entry64Num);
+    Entry64Num = ACPI_INDEX_MAX_TABLES;
+  }
+
+  /* Count the instances of every signature */
+  for (Idx = 0; Idx < Entry64Num; Idx++) {
+    Table = (EFI_ACPI_DESCRIPTION_HEADER *)(UINTN)(Entry64[Idx]);
+    if (Table == NULL) {
+      continue;
+    }
+    if (CalculateSum8 ((UINT8 *)Table, Table->Length)) {
+      acs_print(ACS_PRINT_WARN, L"Checksum of ACPI table 0x%x is invalid \n", Table->Signature);
+    }
+    Slot = pal_acpi_index_slot (Table->Signature);
+    Slot->Signature = Table->Signature;
+    Slot->Count++;
+  }
+
+  /* Give every signature a run of entries, then fill them in XSDT order */
+  for (Idx = 0, Next = 0; Idx < ACPI_INDEX_SLOTS; Idx++) {
+    gAcpiIndex[Idx].First = Next;
+    Next += gAcpiIndex[Idx].Count;
+    gAcpiIndex[Idx].Count = 0;
+  }
+
   for (Idx = 0; Idx < Entry64Num; Idx++) {
-    if (*(UINT32 *)(UINTN)(Entry64[Idx]) == EFI_ACPI_6_1_MULTIPLE_APIC_DESCRIPTION_TABLE_SIGNATURE) {
-      return (UINT64)(Entry64[Idx]);
+    Table = (EFI_ACPI_DESCRIPTION_HEADER *)(UINTN)(Entry64[Idx]);
+    if (Table == NULL) {
+      continue;
+    }
+    Slot = pal_acpi_index_slot (Table->Signature);
+    gAcpiTables[Slot->First + Slot->Count++] = Entry64[Idx];
+  }
+}
+
+/**
+ * @brief   Search the XSDT entries past the index for an instance of a signature
+ * @param   Signature  ACPI table signature
+ * @param   Instance   Instance of the signature among the entries not indexed
+ * @return  64-bit table address, 0 if not present
+ */
+STATIC
+UINT64
+pal_acpi_scan_tables (
+    UINT32 Signature,
+    UINT32 Instance
+  )
+{
+  EFI_ACPI_DESCRIPTION_HEADER   *Table;
+  UINT32                        Idx;
+
+  for (Idx = ACPI_INDEX_MAX_TABLES; Idx < gAcpiEntry64Num; Idx++) {
+    Table = (EFI_ACPI_DESCRIPTION_HEADER *)(UINTN)(gAcpiEntry64[Idx]);
+    if (Table == NULL || Table->Signature != Signature) {
+      continue;
+    }
+    if (Instance-- == 0) {
+      return gAcpiEntry64[Idx];
     }
   }
 
   return 0;
 }
+
+/**
+ * @brief   Look up an ACPI table in the signature index. The index is created
+ *          on the first lookup. Instances not in the index are searched in the
+ *          rest of the XSDT.
+ * @param   Signature  ACPI table signature
+ * @param   Instance   Instance of the signature, 0 for the first table
+ * @return  64-bit table address, 0 if not present
+ */
+UINT64
+pal_acpi_get_table (
+    UINT32 Signature,
+    UINT32 Instance
+  )
+{
+  ACPI_INDEX_SLOT   *Slot;
+
+  if (!gAcpiIndexCreated) {
+    pal_acpi_index_create ();
+  }
+
+  Slot = pal_acpi_index_slot (Signature);
+  if (Slot->Signature != Signature) {
+    return pal_acpi_scan_tables (Signature, Instance);
+  }
+  if (Instance >= Slot->Count) {
+    return pal_acpi_scan_tables (Signature, Instance - Slot->Count);
+  }
+
+  return gAcpiTables[Slot->First + Instance];
+}
+
+/**
+ * @brief   Look up the MADT in the ACPI table index
+ * @param   None
+ * @return  64-bit MADT address
+ */
+UINT64
+pal_get_madt_ptr (
+    VOID
+  )
+{
+  return pal_acpi_get_table (EFI_ACPI_6_1_MULTIPLE_APIC_DESCRIPTION_TABLE_SIGNATURE, 0);
+}
+
+/**
+ * @brief   Look up the SRAT in the ACPI table index
+ * @param   None
+ * @return  64-bit SRAT address, 0 if the platform has no SRAT
+ */
+UINT64
+pal_get_srat_ptr (
+    VOID
+  )
+{
+  return pal_acpi_get_table (EFI_ACPI_6_1_SYSTEM_RESOURCE_AFFINITY_TABLE_SIGNATURE, 0);
+}
@@ -35,6 +35,34 @@ EFI_HARDWARE_INTERRUPT_PROTOCOL *gInterrupt = NULL;
 UINT64
 pal_get_madt_ptr();
 
+/**
+ * @brief   Return the interrupt controller protocol. The protocol database is
+ *          searched on the first call only, so that the EOI path of an ISR
+ *          does not pay for a lookup.
+ *
+ * @param   None
+ *
+ * @return  Protocol instance, NULL if not found
+ */
+STATIC
+EFI_HARDWARE_INTERRUPT_PROTOCOL *
+PalGetInterruptProtocol (
+  VOID
+  )
+{
+
+    EFI_STATUS  Status;
+
+    if (gInterrupt == NULL) {
+        Status = gBS->LocateProtocol (&gHardwareInterruptProtocolGuid, NULL, (VOID **)&gInterrupt);
+        if (EFI_ERROR(Status)) {
+            gInterrupt = NULL;
+        }
+    }
+
+    return gInterrupt;
+}
+
 /**
  * @brief   Populate information about the GIC sub-system at the input address.
  *          In a UEFI-ACPI framework, this information is part of the MADT table.
@@ -135,8 +163,7 @@ pal_gic_install_isr(UINT32 int_id,  VOID (*isr)())
     EFI_STATUS  Status;
 
     /* Find the interrupt controller protocol */
-    Status = gBS->LocateProtocol (&gHardwareInterruptProtocolGuid, NULL, (VOID **)&gInterrupt);
-    if (EFI_ERROR(Status)) {
+    if (PalGetInterruptProtocol() == NULL) {
         return 0xFFFFFFFF;
     }
 
@@ -168,11 +195,8 @@ UINT32
 pal_gic_end_of_interrupt(UINT32 int_id)
 {
 
-    EFI_STATUS  Status;
-
     /* Find the interrupt controller protocol */
-    Status = gBS->LocateProtocol (&gHardwareInterruptProtocolGuid, NULL, (VOID **)&gInterrupt);
-    if (EFI_ERROR(Status)) {
+    if (PalGetInterruptProtocol() == NULL) {
         return 0xFFFFFFFF;
     }
 
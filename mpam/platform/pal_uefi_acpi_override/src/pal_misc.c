@@ -25,7 +25,34 @@
 
 UINT8   *gSharedMemory;
 UINT8  **gSharedMemCpyBuf;
-UINT64  **gSharedLatencyBuf;
+UINT64  *gSharedLatencyBuf;
+UINT32  gSharedLatencyBufStride;
+UINT32  gSharedLatencyBufPages;
+
+UINT64 Arm64ReadCtrPAL(VOID);
+
+/**
+ * @brief   Size of the coherency granule in bytes, from CTR_EL0.CWG, or the
+ *          smallest data cache line, CTR_EL0.DminLine, if CWG is not provided
+ *
+ * @return  Granule size in bytes
+ */
+STATIC
+UINT32
+pal_cache_writeback_granule (
+  VOID
+  )
+{
+
+    UINT64 Ctr = Arm64ReadCtrPAL();
+    UINT32 DminLine = 4 << ((Ctr >> 16) & 0xF);
+    UINT32 Cwg = (Ctr >> 24) & 0xF;
+
+    if (Cwg == 0)
+      return DminLine;
+
+    return ((4U << Cwg) > DminLine) ? (4U << Cwg) : DminLine;
+}
 
 /**
  * @brief   Provides a single point of abstraction to read from all
@@ -95,6 +122,53 @@ pal_print(CHAR8 *string, UINT64 data)
     }
 }
 
+/**
+ * @brief   Sends a formatted string to the structured results file
+ *
+ * @param   string  An ASCII string
+ * @param   data    data for the formatted output
+ *
+ * @return  None
+ */
+VOID
+pal_results_print(CHAR8 *string, UINT64 data)
+{
+
+    CHAR8 Buffer[256];
+    UINTN BufferSize;
+    EFI_STATUS Status;
+
+    if (g_acs_results_file_handle == NULL)
+        return;
+
+    BufferSize = AsciiSPrint(Buffer, sizeof(Buffer), string, data);
+    Status = ShellWriteFile(g_acs_results_file_handle, &BufferSize, (VOID*)Buffer);
+    if (EFI_ERROR(Status)) {
+        acs_print(ACS_PRINT_ERR, L"Error in writing to results file\n");
+    }
+}
+
+/**
+ * @brief   Commits the records written so far to the structured results file,
+ *          so that they survive a hang or reset in a later test
+ *
+ * @return  None
+ */
+VOID
+pal_results_flush(VOID)
+{
+
+    EFI_STATUS Status;
+
+    if (g_acs_results_file_handle == NULL)
+        return;
+
+    Status = ShellFlushFile(g_acs_results_file_handle);
+    if (EFI_ERROR(Status)) {
+        acs_print(ACS_PRINT_ERR, L"Error in flushing results file\n");
+    }
+}
+
 /**
  * @brief   Sends a string to the output console without using UEFI print function
  *          This function will get COMM port address and directly writes to the addr char-by-char
@@ -300,10 +374,12 @@ pal_mem_free_shared_memcpybuf (
 }
 
 /**
- * @brief   Allocate memory which is to be used to share large memories across PEs
+ * @brief   Allocate the shared latency buffer as one contiguous block, with one
+ *          row of ScenarioCnt entries per memory node. Each row starts on its
+ *          own cache line, so rows written by different PEs never share a line.
  *
- * @param   node_cnt    Number of MPAM supported memory nodes in the system
- * @param   sizeofentry Size of memory region allocated to each memory node
+ * @param   NodeCnt     Number of MPAM supported memory nodes in the system
+ * @param   ScenarioCnt Number of latency entries recorded per memory node
  *
  * @return  None
  */
@@ -314,40 +390,28 @@ pal_mem_allocate_shared_latencybuf (
   )
 {
 
-    EFI_STATUS   Status;
-    VOID        *Buffer;
-    UINT32       NodeIndex;
+    EFI_STATUS            Status;
+    EFI_PHYSICAL_ADDRESS  Buffer;
+    UINT32                LineSize = pal_cache_writeback_granule();
 
-    Buffer = NULL;
     gSharedLatencyBuf = NULL;
+    gSharedLatencyBufStride = ((ScenarioCnt * sizeof(UINT64)) + LineSize - 1) & ~(LineSize - 1);
+    gSharedLatencyBufPages = EFI_SIZE_TO_PAGES(NodeCnt * gSharedLatencyBufStride);
 
-    Status = gBS->AllocatePool ( EfiBootServicesData,
-                                 (NodeCnt * sizeof(UINT64)),
-                                 (VOID **) &Buffer );
+    /* Whole pages, so that the block starts cache line aligned */
+    Status = gBS->AllocatePages (AllocateAnyPages, EfiBootServicesData,
+                                 gSharedLatencyBufPages, &Buffer);
 
     if (EFI_ERROR(Status)) {
-      acs_print(ACS_PRINT_ERR, L"Allocate Pool shared latency buf failed %x \n", Status);
+      acs_print(ACS_PRINT_ERR, L"Allocate Pages shared latency buf failed %x \n", Status);
+      return;
     }
 
-    gSharedLatencyBuf = (UINT64 **)Buffer;
-
-    for (NodeIndex = 0; NodeIndex < NodeCnt; NodeIndex++) {
-
-      Buffer = NULL;
-      gSharedLatencyBuf[NodeIndex] = NULL;
-
-      Status = gBS->AllocatePool ( EfiBootServicesData,
-                                  (ScenarioCnt * sizeof(UINT64)),
-                                  (VOID **) &Buffer );
-
-      if (EFI_ERROR(Status)) {
-          acs_print(ACS_PRINT_ERR, L"Allocate Pool shared latency buf failed %x \n", Status);
-      }
-
-      gSharedLatencyBuf[NodeIndex] = (UINT64 *)Buffer;
-    }
+    gSharedLatencyBuf = (UINT64 *)Buffer;
+    gBS->SetMem (gSharedLatencyBuf, NodeCnt * gSharedLatencyBufStride, 0);
 
     pal_pe_data_cache_ops_by_va((UINT64)&gSharedLatencyBuf, CLEAN_AND_INVALIDATE);
+    pal_pe_data_cache_ops_by_va((UINT64)&gSharedLatencyBufStride, CLEAN_AND_INVALIDATE);
 
     return;
 }
@@ -366,9 +430,23 @@ pal_mem_get_shared_latencybuf_addr()
 }
 
 /**
- * @brief   Free the shared latency buffers allocated for all pe
+ * @brief   Return the distance in bytes between the rows of two memory nodes
+ *          in the shared latency buffer
  *
- * @param   PeCnt   number of pes holding latency buffers
+ * @param   None
+ *
+ * @return  row stride in bytes, a multiple of the cache line size
+ */
+UINT32
+pal_mem_get_shared_latencybuf_stride()
+{
+  return gSharedLatencyBufStride;
+}
+
+/**
+ * @brief   Free the shared latency buffer
+ *
+ * @param   NodeCnt number of memory nodes holding latency rows
  *
  * @return  None
  */
@@ -377,13 +455,13 @@ pal_mem_free_shared_latencybuf (
   UINT32 NodeCnt
   )
 {
-    UINT32 NodeIndex;
 
-    for (NodeIndex = 0; NodeIndex < NodeCnt; NodeIndex++) {
-        gBS->FreePool ((VOID *)(UINT64)gSharedLatencyBuf[NodeIndex]);
+    if (gSharedLatencyBuf == NULL) {
+        return;
     }
 
-    gBS->FreePool ((VOID *)gSharedLatencyBuf);
+    gBS->FreePages ((EFI_PHYSICAL_ADDRESS)(UINT64)gSharedLatencyBuf, gSharedLatencyBufPages);
+    gSharedLatencyBuf = NULL;
 }
 
 /**
@@ -471,6 +549,42 @@ pal_mem_allocate_address (
   return Buffer;
 }
 
+/**
+ * @brief  Allocates executable pages at most 64 MB above the given address.
+ *         UEFI allocates from the top of the range down, so the pages are
+ *         usually close enough for a direct branch to the address.
+ *
+ * @param  Near         address the code needs to reach
+ * @param  Size         allocation size in bytes
+ * @retval if SUCCESS   pointer to allocated memory
+ * @retval if FAILURE   NULL
+ */
+VOID *
+pal_mem_allocate_code (
+  UINT64 Near,
+  UINTN Size
+  )
+{
+
+  EFI_STATUS            Status;
+  EFI_PHYSICAL_ADDRESS  BaseAddr;
+
+  BaseAddr = (EFI_PHYSICAL_ADDRESS)(Near + SIZE_64MB);
+  Status = gBS->AllocatePages (
+                     AllocateMaxAddress,
+                     EfiBootServicesCode,
+                     EFI_SIZE_TO_PAGES (Size),
+                     &BaseAddr
+                    );
+
+  if (EFI_ERROR(Status)) {
+    acs_print(ACS_PRINT_ERR, L"AllocatePages failed %x \n", Status);
+    return NULL;
+  }
+
+  return (VOID *) (UINTN) BaseAddr;
+}
+
 VOID
 pal_mem_copy (
   VOID *SourceAddr,
@@ -489,3 +603,106 @@ pal_mem_free_buf (
 {
   gBS->FreePages ((EFI_PHYSICAL_ADDRESS)(UINTN)Buffer, EFI_SIZE_TO_PAGES (Size));
 }
+
+/**
+ * @brief   Read the checkpoint record from the start of the checkpoint file
+ *
+ * @param   Buffer  buffer to hold the checkpoint record
+ * @param   Size    size of the checkpoint record in bytes
+ *
+ * @return  Number of bytes read, 0 if there is no checkpoint file or it is empty
+ */
+UINT32
+pal_checkpoint_read (
+  VOID   *Buffer,
+  UINT32 Size
+  )
+{
+
+    EFI_STATUS Status;
+    UINTN      BufferSize = Size;
+
+    if (g_acs_checkpoint_file_handle == NULL)
+        return 0;
+
+    Status = ShellSetFilePosition(g_acs_checkpoint_file_handle, 0);
+    if (EFI_ERROR(Status))
+        return 0;
+
+    Status = ShellReadFile(g_acs_checkpoint_file_handle, &BufferSize, Buffer);
+    if (EFI_ERROR(Status)) {
+        acs_print(ACS_PRINT_ERR, L"Error in reading checkpoint file %x \n", Status);
+        return 0;
+    }
+
+    return (UINT32)BufferSize;
+}
+
+/**
+ * @brief   Overwrite the checkpoint file with the input record and flush it
+ *          to the media, so that the record survives a reset of the system
+ *
+ * @param   Buffer  checkpoint record
+ * @param   Size    size of the checkpoint record in bytes
+ *
+ * @return  0 for success, 1 for failure
+ */
+UINT32
+pal_checkpoint_write (
+  VOID   *Buffer,
+  UINT32 Size
+  )
+{
+
+    EFI_STATUS Status;
+    UINTN      BufferSize = Size;
+
+    if (g_acs_checkpoint_file_handle == NULL)
+        return 1;
+
+    Status = ShellSetFilePosition(g_acs_checkpoint_file_handle, 0);
+    if (!EFI_ERROR(Status))
+        Status = ShellWriteFile(g_acs_checkpoint_file_handle, &BufferSize, Buffer);
+    if (!EFI_ERROR(Status))
+        Status = ShellFlushFile(g_acs_checkpoint_file_handle);
+
+    if (EFI_ERROR(Status)) {
+        acs_print(ACS_PRINT_ERR, L"Error in writing checkpoint file %x \n", Status);
+        return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief   Append a block of raw measurement samples to the sample file
+ *
+ * @param   Buffer  samples, or the sample file header
+ * @param   Size    size of the block in bytes
+ *
+ * @return  0 for success, 1 for failure
+ */
+UINT32
+pal_samples_write (
+  VOID   *Buffer,
+  UINT32 Size
+  )
+{
+
+    EFI_STATUS Status;
+    UINTN      BufferSize = Size;
+
+    if (g_acs_samples_file_handle == NULL)
+        return 1;
+
+    if (Size == 0)
+        return 0;
+
+    Status = ShellWriteFile(g_acs_samples_file_handle, &BufferSize, Buffer);
+    if (EFI_ERROR(Status)) {
+        acs_print(ACS_PRINT_ERR, L"Error in writing sample file %x \n", Status);
+        return 1;
+    }
+
+    return 0;
+}
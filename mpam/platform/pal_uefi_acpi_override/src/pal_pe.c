@@ -27,13 +27,32 @@
 
 static   EFI_ACPI_6_1_MULTIPLE_APIC_DESCRIPTION_TABLE_HEADER *gMadtHdr;
 UINT8   *gSecondaryPeStack;
+UINT64  *gSecondaryPeMpidr;
+UINT32  gSecondaryPeCount;
 UINT64  gMpidrMax;
 
-/* 256 bytes per core */
-#define SIZE_STACK_SECONDARY_PE  0x200
+/* Stack size of each secondary PE, can be overridden from the build options */
+#ifndef SIZE_STACK_SECONDARY_PE
+#define SIZE_STACK_SECONDARY_PE  0x1000
+#endif
+
+/*
+ * Each PE gets a slot of guard + stack, rounded to a cache line so that
+ * neighbouring stacks do not share a line. The guard sits at the lowest
+ * address of the slot, where an overflowing stack writes first.
+ */
+#define SIZE_CACHE_LINE          64
+#define SIZE_STACK_GUARD         SIZE_CACHE_LINE
+#define SIZE_STACK_SLOT          ((SIZE_STACK_GUARD + SIZE_STACK_SECONDARY_PE + SIZE_CACHE_LINE - 1) & \
+                                  ~(SIZE_CACHE_LINE - 1))
+#define STACK_GUARD_PATTERN      0xA5A5A5A5A5A5A5A5ULL
+
+/* Affinity fields of MPIDR, as matched by the secondary PE entry point */
+#define MPIDR_AFF_MASK           0xFF00FFFFFFULL
 #define UPDATE_AFF_MAX(src,dest,mask)  ((dest & mask) > (src & mask) ? (dest & mask) : (src & mask))
 
 UINT64 pal_get_madt_ptr();
+UINT64 pal_get_srat_ptr();
 
 VOID
 ArmCallSmc (
@@ -52,6 +71,40 @@ PalGetSecondaryStackBase()
     return (UINT64)gSecondaryPeStack;
 }
 
+/**
+ * @brief   Return the size of the stack slot of each secondary PE, the stack of the
+ *          PE at index n starts at the top of slot n.
+ * @param   None
+ * @return  size of a stack slot in bytes
+ */
+UINT64
+PalGetSecondaryStackSize()
+{
+    return SIZE_STACK_SLOT;
+}
+
+/**
+ * @brief   Return the list of MPIDR affinity values, indexed like the stack slots
+ * @param   None
+ * @return  address of the list
+ */
+UINT64
+PalGetSecondaryMpidrList()
+{
+    return (UINT64)gSecondaryPeMpidr;
+}
+
+/**
+ * @brief   Return the number of entries in the secondary PE MPIDR list
+ * @param   None
+ * @return  number of PEs
+ */
+UINT64
+PalGetSecondaryMpidrCount()
+{
+    return gSecondaryPeCount;
+}
+
 /**
  * @brief   Returns the Max of each 8-bit Affinity fields in MPIDR.
  * @param   None
@@ -64,40 +117,137 @@ PalGetMaxMpidr()
 }
 
 /**
- * @brief   Allocate memory region for secondary PE stack use. SIZE of stack for each PE
- *          is a #define
+ * @brief   Allocate memory region for secondary PE stack use, one slot per PE in
+ *          the PE info table. SIZE of stack for each PE is a #define
  *
- * @param   Number of PEs
+ * @param   PeTable - PE info table, filled in
  *
  * @return  None
  */
 VOID
-PalAllocateSecondaryStack(UINT64 mpidr)
+PalAllocateSecondaryStack(PE_INFO_TABLE *PeTable)
 {
     EFI_STATUS Status;
-    UINT32 NumPe, Aff0, Aff1, Aff2, Aff3;
+    UINT32 NumPe, Index;
+    UINT64 *Guard;
 
-    Aff0 = ((mpidr & 0x00000000ff) >>  0);
-    Aff1 = ((mpidr & 0x000000ff00) >>  8);
-    Aff2 = ((mpidr & 0x0000ff0000) >> 16);
-    Aff3 = ((mpidr & 0xff00000000) >> 32);
-
-    NumPe = ((Aff3+1) * (Aff2+1) * (Aff1+1) * (Aff0+1));
+    NumPe = PeTable->header.num_of_pe;
 
     if (gSecondaryPeStack == NULL) {
-        Status = gBS->AllocatePool ( EfiBootServicesData,
-                      (NumPe * SIZE_STACK_SECONDARY_PE),
-                      (VOID **) &gSecondaryPeStack);
+        /* Whole pages, so that the slots start cache line aligned */
+        Status = gBS->AllocatePages (AllocateAnyPages, EfiBootServicesData,
+                      EFI_SIZE_TO_PAGES(NumPe * SIZE_STACK_SLOT),
+                      (EFI_PHYSICAL_ADDRESS *) &gSecondaryPeStack);
         if (EFI_ERROR(Status)) {
             acs_print(ACS_PRINT_ERR, L"\n FATAL - Allocation for Seconday stack failed %x \n", Status);
+            gSecondaryPeStack = NULL;
+            return;
+        }
+
+        Status = gBS->AllocatePool (EfiBootServicesData, NumPe * sizeof(UINT64),
+                      (VOID **) &gSecondaryPeMpidr);
+        if (EFI_ERROR(Status)) {
+            acs_print(ACS_PRINT_ERR, L"\n FATAL - Allocation for Seconday MPIDR list failed %x \n", Status);
+            return;
+        }
+
+        for (Index = 0; Index < NumPe; Index++) {
+            gSecondaryPeMpidr[Index] = PeTable->pe_info[Index].mpidr & MPIDR_AFF_MASK;
+
+            Guard = (UINT64 *)(gSecondaryPeStack + (Index * SIZE_STACK_SLOT));
+            SetMem64 (Guard, SIZE_STACK_GUARD, STACK_GUARD_PATTERN);
+            pal_pe_data_cache_ops_by_va((UINT64)Guard, CLEAN_AND_INVALIDATE);
         }
+
+        pal_pe_data_cache_ops_by_range((UINT64)gSecondaryPeMpidr, NumPe * sizeof(UINT64),
+          CLEAN_AND_INVALIDATE);
+
+        gSecondaryPeCount = NumPe;
         pal_pe_data_cache_ops_by_va((UINT64)&gSecondaryPeStack, CLEAN_AND_INVALIDATE);
+        pal_pe_data_cache_ops_by_va((UINT64)&gSecondaryPeMpidr, CLEAN_AND_INVALIDATE);
+        pal_pe_data_cache_ops_by_va((UINT64)&gSecondaryPeCount, CLEAN_AND_INVALIDATE);
+    }
+}
+
+/**
+ * @brief   Check the guard region below the stack of every secondary PE.
+ *          The guard of a PE found overflowed is filled in again.
+ *
+ * @param   None
+ *
+ * @return  Index of the first PE that overflowed its stack, 0xFFFFFFFF if none
+ */
+UINT32
+pal_pe_check_stack_guard()
+{
+    UINT32 Index, Word;
+    UINT64 *Guard;
+
+    if (gSecondaryPeStack == NULL) {
+        return 0xFFFFFFFF;
+    }
+
+    for (Index = 0; Index < gSecondaryPeCount; Index++) {
+        Guard = (UINT64 *)(gSecondaryPeStack + (Index * SIZE_STACK_SLOT));
+        pal_pe_data_cache_ops_by_va((UINT64)Guard, INVALIDATE);
+
+        for (Word = 0; Word < (SIZE_STACK_GUARD / sizeof(UINT64)); Word++) {
+            if (Guard[Word] != STACK_GUARD_PATTERN) {
+                /* Rearm the guard so that the overflow is reported once */
+                SetMem64 (Guard, SIZE_STACK_GUARD, STACK_GUARD_PATTERN);
+                pal_pe_data_cache_ops_by_va((UINT64)Guard, CLEAN_AND_INVALIDATE);
+                return Index;
+            }
+        }
     }
+
+    return 0xFFFFFFFF;
+}
+
+/**
+ * @brief   Look up the proximity domain of a PE in the GICC Affinity structures of SRAT
+ *
+ * @param   Srat            - SRAT address, NULL if the platform has no SRAT
+ * @param   AcpiProcessorUid - ACPI Processor UID of the PE from its MADT GICC entry
+ *
+ * @return  Proximity domain, PROXIMITY_DOMAIN_UNKNOWN if not described
+ */
+STATIC
+UINT32
+PalGetProximityDomain (
+  EFI_ACPI_6_1_SYSTEM_RESOURCE_AFFINITY_TABLE_HEADER *Srat,
+  UINT32 AcpiProcessorUid
+  )
+{
+
+    EFI_ACPI_6_1_GICC_AFFINITY_STRUCTURE  *Entry;
+    UINT32                                Length;
+
+    if (Srat == NULL)
+        return PROXIMITY_DOMAIN_UNKNOWN;
+
+    Entry = (EFI_ACPI_6_1_GICC_AFFINITY_STRUCTURE *) (Srat + 1);
+    Length = sizeof (EFI_ACPI_6_1_SYSTEM_RESOURCE_AFFINITY_TABLE_HEADER);
+
+    while ((Length < Srat->Header.Length) && Entry->Length) {
+
+        if ((Entry->Type == EFI_ACPI_6_1_GICC_AFFINITY) &&
+            (Entry->AcpiProcessorUid == AcpiProcessorUid) &&
+            (Entry->Flags & EFI_ACPI_6_1_GICC_ENABLED)) {
+            return Entry->ProximityDomain;
+        }
+
+        Length += Entry->Length;
+        Entry = (EFI_ACPI_6_1_GICC_AFFINITY_STRUCTURE *) ((UINT8 *)Entry + (Entry->Length));
+    }
+
+    return PROXIMITY_DOMAIN_UNKNOWN;
 }
 
 /**
  * @brief   This API fills in the PE_INFO Table with information about the PEs in the
- *          system. This is achieved by parsing the ACPI - MADT table.
+ *          system. This is achieved by parsing the ACPI - MADT table, and SRAT
+ *          for the proximity domain of each PE when present.
  *
  * @param   PeTable  - Address where the PE information needs to be filled.
  *
@@ -107,6 +257,7 @@ VOID
 pal_pe_create_info_table(PE_INFO_TABLE *PeTable)
 {
     EFI_ACPI_6_1_GIC_STRUCTURE    *Entry = NULL;
+    EFI_ACPI_6_1_SYSTEM_RESOURCE_AFFINITY_TABLE_HEADER *Srat;
     PE_INFO_ENTRY                 *Ptr = NULL;
     UINT32                        TableLength = 0;
     UINT32                        Length = 0;
@@ -127,6 +278,8 @@ pal_pe_create_info_table(PE_INFO_TABLE *PeTable)
         return;
     }
 
+    Srat = (EFI_ACPI_6_1_SYSTEM_RESOURCE_AFFINITY_TABLE_HEADER *) pal_get_srat_ptr();
+
     PeTable->header.num_of_pe = 0;
 
     Entry = (EFI_ACPI_6_1_GIC_STRUCTURE *) (gMadtHdr + 1);
@@ -140,8 +293,8 @@ pal_pe_create_info_table(PE_INFO_TABLE *PeTable)
             Ptr->mpidr    = Entry->MPIDR;
             Ptr->pe_num   = PeTable->header.num_of_pe;
             Ptr->pmu_gsiv = Entry->PerformanceInterruptGsiv;
+            Ptr->proximity_domain = PalGetProximityDomain(Srat, Entry->AcpiProcessorUid);
             acs_print(ACS_PRINT_DEBUG, L"MPIDR %x PE num %x \n", Ptr->mpidr, Ptr->pe_num);
-            pal_pe_data_cache_ops_by_va((UINT64)Ptr, CLEAN_AND_INVALIDATE);
             Ptr++;
             PeTable->header.num_of_pe++;
 
@@ -157,9 +310,11 @@ pal_pe_create_info_table(PE_INFO_TABLE *PeTable)
     } while (Length < TableLength);
 
     gMpidrMax = MpidrAff0Max | MpidrAff1Max | MpidrAff2Max | MpidrAff3Max;
-    pal_pe_data_cache_ops_by_va((UINT64)PeTable, CLEAN_AND_INVALIDATE);
+    /* Publish the whole table in one maintenance pass */
+    pal_pe_data_cache_ops_by_range((UINT64)PeTable, sizeof(PE_INFO_HDR) +
+      (PeTable->header.num_of_pe * sizeof(PE_INFO_ENTRY)), CLEAN_AND_INVALIDATE);
     pal_pe_data_cache_ops_by_va((UINT64)&gMpidrMax, CLEAN_AND_INVALIDATE);
-    PalAllocateSecondaryStack(gMpidrMax);
+    PalAllocateSecondaryStack(PeTable);
 
 }
 
@@ -308,3 +463,40 @@ pal_pe_data_cache_ops_by_va(UINT64 addr, UINT32 type)
             DataCacheCleanInvalidateVA(addr);
     }
 }
+
+VOID
+DataCacheCleanInvalidateRange(UINT64 addr, UINT64 size);
+
+VOID
+DataCacheCleanRange(UINT64 addr, UINT64 size);
+
+VOID
+DataCacheInvalidateRange(UINT64 addr, UINT64 size);
+
+/**
+ * @brief   Perform cache maintenance operation on every data cache line
+ *          of an address range, completed by a single barrier
+ *
+ * @param   addr - start address of the range
+ * @param   size - size of the range in bytes
+ * @param   type - type of cache ops
+ *
+ * @return  None
+ */
+VOID
+pal_pe_data_cache_ops_by_range(UINT64 addr, UINT64 size, UINT32 type)
+{
+    switch (type) {
+        case CLEAN_AND_INVALIDATE:
+            DataCacheCleanInvalidateRange(addr, size);
+            break;
+        case CLEAN:
+            DataCacheCleanRange(addr, size);
+            break;
+        case INVALIDATE:
+            DataCacheInvalidateRange(addr, size);
+            break;
+        default:
+            DataCacheCleanInvalidateRange(addr, size);
+    }
+}
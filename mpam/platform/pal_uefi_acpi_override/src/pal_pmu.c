@@ -50,6 +50,10 @@ pal_pmu_reg_read (
             return Arm64ReadPmccfiltr();
         case PMCNTENSET_EL0:
             return Arm64ReadPmcntenset();
+        case PMEVTYPER0_EL0:
+            return Arm64ReadPmevtyper0();
+        case PMEVCNTR0_EL0:
+            return Arm64ReadPmevcntr0();
         default:
             acs_print(ACS_PRINT_ERR, L"\n FATAL - Unsupported PMU register read \n");
     }
@@ -84,6 +88,15 @@ pal_pmu_reg_write (
         case PMCNTENSET_EL0:
             Arm64WritePmcntenset(WriteData);
             break;
+        case PMCNTENCLR_EL0:
+            Arm64WritePmcntenclr(WriteData);
+            break;
+        case PMEVTYPER0_EL0:
+            Arm64WritePmevtyper0(WriteData);
+            break;
+        case PMEVCNTR0_EL0:
+            Arm64WritePmevcntr0(WriteData);
+            break;
         default:
             acs_print(ACS_PRINT_ERR, L"\n FATAL - Unsupported PMU register read \n");
     }
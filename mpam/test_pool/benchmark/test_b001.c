@@ -0,0 +1,200 @@
+/** @file
+ * Copyright (c) 2018, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#include "val/include/val_infra.h"
+#include "val/include/val_node_infra.h"
+#include "val/include/val_mpam_hwreg_defs.h"
+#include "val/include/val_benchmark.h"
+#include "val/include/val_results.h"
+#include "val/include/val_samples.h"
+
+#define TEST_NUM   ACS_BENCH_TEST_NUM_BASE  +  1
+#define TEST_DESC  "Measure PARTID switch cost          "
+
+#define BENCH_LINE_SIZE     64
+#define BENCH_BUF_SIZE      (BENCH_SAMPLE_CNT * BENCH_LINE_SIZE)
+
+/* Number of PARTID switches timed together for the throughput scenario */
+#define BENCH_SWITCH_BATCH  64
+
+static uint64_t samples[BENCH_SAMPLE_CNT];
+
+static uint64_t set_partid(uint64_t mpamn_elx, uint16_t partid)
+{
+
+    /* Clear the PARTID_D & PMG_D bits before writing to them */
+    mpamn_elx = CLEAR_BITS_M_TO_N(mpamn_elx, MPAMn_ELx_PARTID_D_SHIFT+15, MPAMn_ELx_PARTID_D_SHIFT);
+    mpamn_elx = CLEAR_BITS_M_TO_N(mpamn_elx, MPAMn_ELx_PMG_D_SHIFT+7, MPAMn_ELx_PMG_D_SHIFT);
+
+    return mpamn_elx | (((uint64_t)DEFAULT_PMG << MPAMn_ELx_PMG_D_SHIFT) |
+                        ((uint64_t)partid << MPAMn_ELx_PARTID_D_SHIFT));
+}
+
+static void measure_sysreg_write(sysreg_mpam_t regid, uint64_t value_a, uint64_t value_b)
+{
+
+    uint32_t index;
+    uint64_t value;
+    uint64_t start_time;
+    uint64_t end_time;
+
+    for (index = 0; index < BENCH_SAMPLE_CNT; index++) {
+        value = (index & 1) ? value_b : value_a;
+
+        start_time = val_measurement_read();
+        val_sysreg_write(regid, value);
+        end_time = val_measurement_read();
+        samples[index] = end_time - start_time;
+    }
+}
+
+static void payload()
+{
+
+    uint32_t pe_index;
+    uint32_t index;
+    uint32_t batch;
+    uint16_t partid_b;
+    uint64_t mpamidr;
+    uint64_t mpam1_el1;
+    uint64_t mpam2_el2;
+    uint64_t mpam2_a;
+    uint64_t mpam2_b;
+    uint64_t start_time;
+    uint64_t end_time;
+    volatile uint8_t *buf;
+    VAL_BENCH_STATS_t stats;
+
+    pe_index = val_pe_get_index_mpid(val_pe_get_mpid());
+
+    /* Alternate between the default PARTID and the next PARTID the PE can generate */
+    mpamidr = val_sysreg_read(MPAMIDR_SYSREG);
+    partid_b = GET_MIN_VALUE((mpamidr >> MPAMIDR_PARTID_MAX_SHIFT) & MPAMIDR_PARTID_MAX_MASK,
+                             DEFAULT_PARTID + 1);
+
+    val_print(ACS_PRINT_DEBUG, "\n       partid_b            = %d", partid_b);
+
+    /* Skip this benchmark if the PE supports a single PARTID */
+    if (partid_b == DEFAULT_PARTID) {
+        val_set_status(pe_index, RESULT_SKIP(TEST_NUM, 01));
+        return;
+    }
+
+    buf = (volatile uint8_t *)val_allocate_buf(BENCH_BUF_SIZE);
+    if (buf == NULL) {
+        val_print(ACS_PRINT_ERR, "\n       Mem allocation for benchmark buffer failed", 0x0);
+        val_set_status(pe_index, RESULT_FAIL(TEST_NUM, 01));
+        return;
+    }
+
+    mpam1_el1 = val_sysreg_read(MPAM1_SYSREG);
+    mpam2_el2 = val_sysreg_read(MPAM2_SYSREG);
+    mpam2_a = set_partid(mpam2_el2, DEFAULT_PARTID);
+    mpam2_b = set_partid(mpam2_el2, partid_b);
+
+    val_measurement_start();
+
+    /* Scenario 0 : cost of an MPAM2_EL2 write changing the PARTID */
+    measure_sysreg_write(MPAM2_SYSREG, mpam2_a, mpam2_b);
+    val_samples_record_array(ACS_RESULTS_NODE_PE, ACS_RESULTS_ALL_NODES, 0, partid_b,
+                             samples, BENCH_SAMPLE_CNT, ACS_SAMPLE_UNIT_CYCLES);
+    val_benchmark_get_stats(samples, BENCH_SAMPLE_CNT, &stats);
+    val_benchmark_report("MPAM2_EL2 write latency (cycles)",
+                         ACS_RESULTS_NODE_PE, ACS_RESULTS_ALL_NODES, 0, partid_b, &stats);
+
+    /* Scenario 1 : cost of an MPAM1_EL1 write changing the PARTID */
+    measure_sysreg_write(MPAM1_SYSREG, set_partid(mpam1_el1, DEFAULT_PARTID),
+                         set_partid(mpam1_el1, partid_b));
+    val_sysreg_write(MPAM1_SYSREG, mpam1_el1);
+    val_samples_record_array(ACS_RESULTS_NODE_PE, ACS_RESULTS_ALL_NODES, 1, partid_b,
+                             samples, BENCH_SAMPLE_CNT, ACS_SAMPLE_UNIT_CYCLES);
+    val_benchmark_get_stats(samples, BENCH_SAMPLE_CNT, &stats);
+    val_benchmark_report("MPAM1_EL1 write latency (cycles)",
+                         ACS_RESULTS_NODE_PE, ACS_RESULTS_ALL_NODES, 1, partid_b, &stats);
+
+    /*
+     * Scenario 2 : latency of the first memory access after a PARTID
+     * change, the line is evicted so that the access leaves the PE
+     */
+    for (index = 0; index < BENCH_SAMPLE_CNT; index++) {
+        val_data_cache_ops_by_va((addr_t)&buf[index * BENCH_LINE_SIZE], CLEAN_AND_INVALIDATE);
+        val_sysreg_write(MPAM2_SYSREG, (index & 1) ? mpam2_b : mpam2_a);
+
+        start_time = val_measurement_read();
+        (void)buf[index * BENCH_LINE_SIZE];
+        end_time = val_measurement_read();
+        samples[index] = end_time - start_time;
+    }
+
+    val_samples_record_array(ACS_RESULTS_NODE_PE, ACS_RESULTS_ALL_NODES, 2, partid_b,
+                             samples, BENCH_SAMPLE_CNT, ACS_SAMPLE_UNIT_CYCLES);
+    val_benchmark_get_stats(samples, BENCH_SAMPLE_CNT, &stats);
+    val_benchmark_report("First access latency after switch (cycles)",
+                         ACS_RESULTS_NODE_PE, ACS_RESULTS_ALL_NODES, 2, partid_b, &stats);
+
+    /*
+     * Scenario 3 : throughput of a loop alternating between the two
+     * PARTIDs with one memory access per switch
+     */
+    for (index = 0; index < BENCH_SAMPLE_CNT; index++) {
+        start_time = val_measurement_read();
+        for (batch = 0; batch < BENCH_SWITCH_BATCH; batch++) {
+            val_sysreg_write(MPAM2_SYSREG, (batch & 1) ? mpam2_b : mpam2_a);
+            (void)buf[batch * BENCH_LINE_SIZE];
+        }
+        end_time = val_measurement_read();
+        samples[index] = (end_time - start_time) / BENCH_SWITCH_BATCH;
+    }
+
+    val_samples_record_array(ACS_RESULTS_NODE_PE, ACS_RESULTS_ALL_NODES, 3, partid_b,
+                             samples, BENCH_SAMPLE_CNT, ACS_SAMPLE_UNIT_CYCLES);
+    val_benchmark_get_stats(samples, BENCH_SAMPLE_CNT, &stats);
+    val_benchmark_report("Alternating switch loop (cycles per switch)",
+                         ACS_RESULTS_NODE_PE, ACS_RESULTS_ALL_NODES, 3, partid_b, &stats);
+
+    val_measurement_stop();
+
+    /* Restore MPAM2_EL2 settings */
+    val_sysreg_write(MPAM2_SYSREG, mpam2_el2);
+
+    val_free_buf((void *)buf, BENCH_BUF_SIZE);
+
+    val_set_status(pe_index, RESULT_PASS(TEST_NUM, 01));
+
+    return;
+}
+
+uint32_t testb001_entry()
+{
+
+    uint32_t status = ACS_STATUS_FAIL;
+    uint32_t num_pe = 1;
+
+    status = val_initialize_test(TEST_NUM, TEST_DESC, num_pe);
+
+    /* This check is when user is forcing us to skip this test */
+    if (status != ACS_STATUS_SKIP)
+        val_run_test_payload(TEST_NUM, num_pe, payload, 0);
+
+    /* get the result from all PE and check for failure */
+    status = val_check_for_error(TEST_NUM, num_pe);
+
+
+    val_report_status(0, ACS_TEST_END(TEST_NUM));
+
+    return status;
+}
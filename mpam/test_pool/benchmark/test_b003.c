@@ -0,0 +1,242 @@
+/** @file
+ * Copyright (c) 2018, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#include "val/include/val_infra.h"
+#include "val/include/val_memory.h"
+#include "val/include/val_node_infra.h"
+#include "val/include/val_mpam_hwreg_defs.h"
+#include "val/include/val_benchmark.h"
+#include "val/include/val_results.h"
+#include "val/include/val_samples.h"
+
+#define TEST_NUM   ACS_BENCH_TEST_NUM_BASE  +  3
+#define TEST_DESC  "Measure MBWU overflow interrupt latency"
+
+static uint32_t node_index;
+static uint32_t intr_num;
+static uint64_t mpam2_el2_temp;
+static volatile uint64_t isr_entry_time;
+static uint64_t samples[BENCH_INTR_CNT];
+
+static void intr_handler()
+{
+    uint32_t pe_index = val_pe_get_index_mpid(val_pe_get_mpid());
+
+    /* Prefer the time sampled at IRQ entry by the native interrupt path */
+    isr_entry_time = val_gic_get_irq_entry_time();
+    if (isr_entry_time == 0)
+        isr_entry_time = val_measurement_get_counter();
+
+    val_set_status(pe_index, RESULT_PASS(TEST_NUM, 01));
+
+    /* Write 0b0000 into MPAMF_ESR.ERRCODE to clear the interrupt */
+    val_node_clear_intr(MPAM_NODE_MEMORY, node_index);
+
+    /* Send EOI to the CPU Interface */
+    val_gic_end_of_interrupt(intr_num);
+}
+
+static void payload()
+{
+
+    uint16_t mon_count;
+    uint32_t index;
+    uint32_t iter;
+    uint32_t pe_index;
+    uint32_t total_nodes;
+    uint32_t timeout;
+    uint32_t intr_count = 0;
+    uint32_t sample_count;
+    uint32_t pended_count;
+    uint32_t measured_count = 0;
+    uint64_t mpam2_el2;
+    uint64_t start_time;
+    void *src_buf;
+    void *dest_buf;
+    VAL_BENCH_STATS_t stats;
+
+    pe_index = val_pe_get_index_mpid(val_pe_get_mpid());
+    total_nodes = val_node_get_total(MPAM_NODE_MEMORY);
+
+    mpam2_el2 = val_sysreg_read(MPAM2_SYSREG);
+    mpam2_el2_temp = mpam2_el2;
+
+    /* Clear the PARTID_D & PMG_D bits in mpam2_el2 before writing to them */
+    mpam2_el2 = CLEAR_BITS_M_TO_N(mpam2_el2, MPAMn_ELx_PARTID_D_SHIFT+15, MPAMn_ELx_PARTID_D_SHIFT);
+    mpam2_el2 = CLEAR_BITS_M_TO_N(mpam2_el2, MPAMn_ELx_PMG_D_SHIFT+7, MPAMn_ELx_PMG_D_SHIFT);
+
+    /* Write default partid and default pmg to mpam2_el2 to generate PE traffic */
+    mpam2_el2 |= (((uint64_t)DEFAULT_PMG << MPAMn_ELx_PMG_D_SHIFT) |
+                  ((uint64_t)DEFAULT_PARTID << MPAMn_ELx_PARTID_D_SHIFT));
+
+    val_sysreg_write(MPAM2_SYSREG, mpam2_el2);
+
+    for (index = 0; index < total_nodes; index++) {
+
+        node_index = index;
+        intr_num = val_node_get_oflow_intrnum(MPAM_NODE_MEMORY, node_index);
+
+        /* Read the number of monitors implemented in this MSC */
+        mon_count = 0;
+        if (val_node_supports_mon(MPAM_NODE_MEMORY, node_index)) {
+            mon_count = val_memory_supports_mbwumon(node_index) ?
+                        val_memory_mon_count(node_index) : 0;
+        }
+
+        /*
+         * Skip this MSC if it doesn't implement overflow interrupt
+         * support (or) if it doesn't implement any monitors
+         */
+        if ((intr_num == 0) || (mon_count == 0)) {
+            continue;
+        } else {
+            intr_count++;
+        }
+
+        /* Register the interrupt handler */
+        if (val_gic_install_isr(intr_num, intr_handler) == ACS_STATUS_ERR) {
+            val_set_status(pe_index, RESULT_FAIL(TEST_NUM, 02));
+            val_sysreg_write(MPAM2_SYSREG, mpam2_el2_temp);
+            return;
+        }
+
+        /* Enable affinity routing to receive intr_num on primary PE */
+        if (intr_num >= BENCH_SPI_BASE)
+            val_gic_route_interrupt_to_pe(intr_num, val_pe_get_mpid_index(pe_index));
+
+        /* Buffers for the traffic that overflows the monitor, outside the measurement */
+        src_buf = val_allocate_address(val_memory_get_base(node_index),
+                                       val_memory_get_size(node_index), TWO_MB);
+        dest_buf = val_allocate_address(val_memory_get_base(node_index),
+                                        val_memory_get_size(node_index), TWO_MB);
+        if ((src_buf == NULL) || (dest_buf == NULL)) {
+            val_print(ACS_PRINT_ERR, "\n       Mem allocation for MBWU buffers failed", 0x0);
+            if (src_buf)
+                val_free_buf(src_buf, TWO_MB);
+            val_set_status(pe_index, RESULT_FAIL(TEST_NUM, 03));
+            val_sysreg_write(MPAM2_SYSREG, mpam2_el2_temp);
+            return;
+        }
+
+        sample_count = 0;
+        pended_count = 0;
+        for (iter = 0; iter < BENCH_INTR_CNT; iter++) {
+
+            /* Set the interrupt status to pending */
+            val_set_status(pe_index, RESULT_PENDING(TEST_NUM));
+
+            /* Arm the monitor at its maximum value before the measurement */
+            val_node_setup_msmon_oflow(node_index, mon_count);
+
+            /* The first bytes of traffic overflow the monitor, time from there */
+            start_time = val_measurement_get_counter();
+            val_mem_copy(src_buf, dest_buf, TWO_MB);
+
+            /*
+             * Fall back to pending the interrupt if the overflow did not raise it,
+             * so the ISR still clears the MSC. No overflow was timed, so the
+             * iteration gives no sample.
+             */
+            if (IS_RESULT_PENDING(val_get_status(pe_index))) {
+                pended_count++;
+                start_time = 0;
+                val_gic_write_ispendreg(intr_num);
+            }
+
+            /* PE busy polls to check the completion of interrupt service routine */
+            timeout = TIMEOUT_LARGE;
+            while ((--timeout > 0) && (IS_RESULT_PENDING(val_get_status(pe_index))));
+
+            /* Restore Error Control Register original settings */
+            val_node_restore_ecr(MPAM_NODE_MEMORY, node_index);
+
+            if (timeout == 0) {
+                val_print(ACS_PRINT_ERR, "\n MBWU Oflow Interrupt not received on %d   ", intr_num);
+                val_free_buf(src_buf, TWO_MB);
+                val_free_buf(dest_buf, TWO_MB);
+                val_set_status(pe_index, RESULT_FAIL(TEST_NUM, 02));
+                val_sysreg_write(MPAM2_SYSREG, mpam2_el2_temp);
+                return;
+            }
+
+            /* An ISR entry stamped before the traffic started is not a sample */
+            if ((start_time != 0) && (isr_entry_time >= start_time))
+                samples[sample_count++] = isr_entry_time - start_time;
+        }
+
+        val_free_buf(src_buf, TWO_MB);
+        val_free_buf(dest_buf, TWO_MB);
+
+        if (pended_count)
+            val_print(ACS_PRINT_WARN, "\n       Overflow did not raise the interrupt in %d iterations",
+                      pended_count);
+
+        if (sample_count == 0) {
+            val_print(ACS_PRINT_WARN, "\n       No overflow interrupt latency measured on %d",
+                      intr_num);
+            continue;
+        }
+
+        val_samples_record_array(MPAM_NODE_MEMORY, node_index, 0, DEFAULT_PARTID,
+                                 samples, sample_count, ACS_SAMPLE_UNIT_TICKS);
+
+        /* The raw samples are counter ticks, the report is in ns */
+        for (iter = 0; iter < sample_count; iter++)
+            samples[iter] = val_benchmark_ticks_to_ns(samples[iter]);
+
+        measured_count++;
+        val_benchmark_get_stats(samples, sample_count, &stats);
+        val_benchmark_report((intr_num >= BENCH_SPI_BASE) ?
+                             "SPI overflow interrupt latency (ns)" : "PPI overflow interrupt latency (ns)",
+                             MPAM_NODE_MEMORY, node_index, 0, DEFAULT_PARTID, &stats);
+    }
+
+    /* Restore MPAM2_EL2 settings */
+    val_sysreg_write(MPAM2_SYSREG, mpam2_el2_temp);
+
+    /*
+     * Set the test status to Skip if none of the MPAM nodes implement overflow
+     * interrupts, or none of them raised one from the traffic
+     */
+    if ((intr_count == 0) || (measured_count == 0)) {
+        val_set_status(pe_index, RESULT_SKIP(TEST_NUM, 0));
+        return;
+    }
+
+    val_set_status(pe_index, RESULT_PASS(TEST_NUM, 01));
+    return;
+}
+
+uint32_t testb003_entry()
+{
+
+    uint32_t status = ACS_STATUS_FAIL;
+    uint32_t num_pe = 1;
+
+    status = val_initialize_test(TEST_NUM, TEST_DESC, num_pe);
+
+    /* This check is when user is forcing us to skip this test */
+    if (status != ACS_STATUS_SKIP)
+        val_run_test_payload(TEST_NUM, num_pe, payload, 0);
+
+    /* get the result from all PE and check for failure */
+    status = val_check_for_error(TEST_NUM, num_pe);
+
+    val_report_status(0, ACS_TEST_END(TEST_NUM));
+
+    return status;
+}
@@ -0,0 +1,386 @@
+/** @file
+ * Copyright (c) 2018, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#include "val/include/val_infra.h"
+#include "val/include/val_cache.h"
+#include "val/include/val_memory.h"
+#include "val/include/val_node_infra.h"
+#include "val/include/val_mpam_hwreg_defs.h"
+#include "val/include/val_benchmark.h"
+#include "val/include/val_results.h"
+#include "val/include/val_samples.h"
+
+#define TEST_NUM   ACS_BENCH_TEST_NUM_BASE  +  4
+#define TEST_DESC  "Characterize MBWMAX/MBWMIN regulation"
+
+/* Shared memcopy buffer of every PE, half source and half destination */
+#define SWEEP_BUF_SIZE      (64 * ONE_MB)
+
+/* Upper bound on the number of steps swept per control */
+#define SWEEP_STEPS_MAX     32
+
+/* Number of copies measured per step, the best one is kept */
+#define SWEEP_COPY_CNT      4
+
+/* Bandwidth changes below this value (per mille) are measurement noise */
+#define SWEEP_NOISE         20
+
+/*
+ * Result scenarios reported for every swept control of a memory node.
+ * The MBWMIN scenarios follow the MBWMAX ones at SWEEP_SCENARIO_MBWMIN.
+ */
+#define SWEEP_SCENARIO_LINEARITY    0
+#define SWEEP_SCENARIO_MONOTONIC    1
+#define SWEEP_SCENARIO_STEP         2
+#define SWEEP_SCENARIO_MBWMIN       3
+
+typedef enum {
+    SWEEP_MBWMAX = 0,
+    SWEEP_MBWMIN
+} sweep_control_t;
+
+static uint64_t mpam2_el2_temp;
+
+static void config_mpam_params(uint16_t partid)
+{
+
+    uint64_t mpam2_el2 = mpam2_el2_temp;
+
+    /* Clear the PARTID_D & PMG_D bits in mpam2_el2 before writing to them */
+    mpam2_el2 = CLEAR_BITS_M_TO_N(mpam2_el2, MPAMn_ELx_PARTID_D_SHIFT+15, MPAMn_ELx_PARTID_D_SHIFT);
+    mpam2_el2 = CLEAR_BITS_M_TO_N(mpam2_el2, MPAMn_ELx_PMG_D_SHIFT+7, MPAMn_ELx_PMG_D_SHIFT);
+
+    /* Write the PARTID & DEFAULT PMG to mpam2_el2 to generate PE traffic */
+    mpam2_el2 |= (((uint64_t)DEFAULT_PMG << MPAMn_ELx_PMG_D_SHIFT) |
+                  ((uint64_t)partid << MPAMn_ELx_PARTID_D_SHIFT));
+
+    val_sysreg_write(MPAM2_SYSREG, mpam2_el2);
+}
+
+/**
+ * @brief   Measure the stream copy bandwidth achieved by this PE
+ * @param   buf      - shared memcopy buffer of this PE
+ * @return  Best bandwidth of SWEEP_COPY_CNT copies in MB/s, counting the
+ *          bytes read and written
+ */
+static uint64_t measure_bandwidth(uint8_t *buf)
+{
+
+    uint32_t index;
+    uint64_t start_time;
+    uint64_t end_time;
+    uint64_t elapsed_ns;
+    uint64_t bandwidth;
+    uint64_t best = 0;
+    uint64_t copy_size = SWEEP_BUF_SIZE / 2;
+
+    for (index = 0; index < SWEEP_COPY_CNT; index++) {
+        start_time = val_measurement_get_counter();
+        val_mem_copy((void *)buf, (void *)(buf + copy_size), copy_size);
+        end_time = val_measurement_get_counter();
+
+        elapsed_ns = val_benchmark_ticks_to_ns(end_time - start_time);
+        if (elapsed_ns == 0)
+            continue;
+
+        bandwidth = (2 * copy_size * 1000) / elapsed_ns;
+        best = GET_MAX_VALUE(best, bandwidth);
+    }
+
+    return best;
+}
+
+static void configure_control(sweep_control_t control, uint32_t node_index,
+                              uint16_t partid, uint32_t percentage)
+{
+
+    if (control == SWEEP_MBWMAX)
+        val_memory_configure_mbwmax(node_index, partid, HARDLIMIT_EN, percentage);
+    else
+        val_memory_configure_mbwmin(node_index, partid, percentage);
+}
+
+/**
+ * @brief   Sweep one bandwidth control of a memory node from its minimum
+ *          step to 100% and characterize the achieved bandwidth curve.
+ *          MBWMAX is swept on an idle MSC, MBWMIN against aggressor traffic
+ *          of the default PARTID since a minimum only shows under contention.
+ * @return  ACS_STATUS_PASS, ACS_STATUS_SKIP when the sweep can not be run,
+ *          or ACS_STATUS_ERR if the aggressors did not complete
+ */
+static uint32_t sweep_control(sweep_control_t control, uint32_t node_index,
+                              uint16_t partid, uint8_t *buf)
+{
+
+    uint32_t step;
+    uint32_t step_cnt;
+    uint32_t width;
+    uint32_t percentage;
+    uint32_t programmed;
+    uint32_t expected;
+    uint32_t achieved;
+    uint32_t floor = 0;
+    uint32_t prev_achieved = 0;
+    uint32_t level_expected = 0;
+    uint32_t level_achieved = 0;
+    uint32_t first_expected = 0;
+    uint32_t level_cnt = 0;
+    uint32_t linearity_err = 0;
+    uint32_t monotonic_err = 0;
+    uint32_t eff_step;
+    uint32_t scenario_base;
+    uint64_t bandwidth;
+    uint64_t baseline;
+
+    if (control == SWEEP_MBWMAX) {
+        width = val_memory_mbwmax_width(node_index);
+        scenario_base = 0;
+    } else {
+        width = val_memory_mbwmin_width(node_index);
+        scenario_base = SWEEP_SCENARIO_MBWMIN;
+    }
+
+    if ((width == 0) || (width > 16))
+        return ACS_STATUS_SKIP;
+
+    step_cnt = GET_MIN_VALUE(1U << width, SWEEP_STEPS_MAX);
+
+    /* The uncontended, unregulated bandwidth is the 100% reference */
+    val_memory_configure_mbwmax(node_index, partid, HARDLIMIT_DIS, 100);
+    val_memory_configure_mbwmin(node_index, partid, 0);
+    baseline = measure_bandwidth(buf);
+    if (baseline == 0)
+        return ACS_STATUS_SKIP;
+
+    if (control == SWEEP_MBWMIN) {
+        if (val_benchmark_start_aggressors(MPAM_NODE_MEMORY, node_index, DEFAULT_PARTID,
+                                           SWEEP_BUF_SIZE) == 0) {
+            val_print(ACS_PRINT_TEST, "\n       No aggressor PE, MBWMIN sweep skipped, node %d",
+                      node_index);
+            return ACS_STATUS_SKIP;
+        }
+
+        /* Share of the bandwidth the PARTID gets under contention without a minimum */
+        floor = (measure_bandwidth(buf) * BENCH_PER_MILLE) / baseline;
+    }
+
+    val_print(ACS_PRINT_TEST, "\n       %a sweep", (uint64_t)((control == SWEEP_MBWMAX) ? "MBWMAX" : "MBWMIN"));
+    val_print(ACS_PRINT_TEST, ", node %d", node_index);
+    val_print(ACS_PRINT_TEST, ", BWA_WD %d", width);
+    val_print(ACS_PRINT_TEST, ", baseline %ld MB/s", baseline);
+
+    for (step = 1; step <= step_cnt; step++) {
+        percentage = (100 * step) / step_cnt;
+
+        /* Number of 1/2^BWA_WD units the fixed-point conversion programs */
+        programmed = ((1U << width) * percentage) / 100;
+        if (programmed == 0)
+            continue;
+
+        configure_control(control, node_index, partid, percentage);
+        bandwidth = measure_bandwidth(buf);
+
+        expected = (programmed * BENCH_PER_MILLE) >> width;
+        achieved = (uint32_t)((bandwidth * BENCH_PER_MILLE) / baseline);
+
+        /* A minimum below the uncontended share is already met */
+        if (control == SWEEP_MBWMIN)
+            expected = GET_MAX_VALUE(expected, floor);
+
+        val_print(ACS_PRINT_DEBUG, "\n         %3d%%", percentage);
+        val_print(ACS_PRINT_DEBUG, "  expected %4d", expected);
+        val_print(ACS_PRINT_DEBUG, "  achieved %4d", achieved);
+
+        linearity_err = GET_MAX_VALUE(linearity_err, (achieved > expected) ?
+                                      (achieved - expected) : (expected - achieved));
+
+        if (level_cnt && (achieved + SWEEP_NOISE < prev_achieved))
+            monotonic_err++;
+
+        /* A new level is reached when the achieved bandwidth moves beyond the noise */
+        if ((level_cnt == 0) || (achieved > level_achieved + SWEEP_NOISE) ||
+            (achieved + SWEEP_NOISE < level_achieved)) {
+            if (level_cnt == 0)
+                first_expected = expected;
+            level_expected = expected;
+            level_achieved = achieved;
+            level_cnt++;
+        }
+
+        prev_achieved = achieved;
+    }
+
+    if ((control == SWEEP_MBWMIN) && (val_benchmark_stop_aggressors() != ACS_STATUS_PASS))
+        return ACS_STATUS_ERR;
+
+    /* Leave the control disabled for the next sweep */
+    if (control == SWEEP_MBWMAX)
+        val_memory_configure_mbwmax(node_index, partid, HARDLIMIT_DIS, 100);
+    else
+        val_memory_configure_mbwmin(node_index, partid, 0);
+
+    /* Configured range covered per distinguishable level of achieved bandwidth */
+    eff_step = (level_cnt > 1) ? (level_expected - first_expected) / (level_cnt - 1)
+                               : BENCH_PER_MILLE;
+
+    val_print(ACS_PRINT_TEST, "\n         linearity error = %d per mille", linearity_err);
+    val_print(ACS_PRINT_TEST, "  monotonicity violations = %d", monotonic_err);
+    val_print(ACS_PRINT_TEST, "  effective step = %d per mille", eff_step);
+    val_print(ACS_PRINT_TEST, " (nominal %d)", BENCH_PER_MILLE >> width);
+
+    val_results_add_sample(MPAM_NODE_MEMORY, node_index, scenario_base + SWEEP_SCENARIO_LINEARITY,
+                           partid, linearity_err, ACS_SAMPLE_UNIT_COUNT);
+    val_results_add_sample(MPAM_NODE_MEMORY, node_index, scenario_base + SWEEP_SCENARIO_MONOTONIC,
+                           partid, monotonic_err, ACS_SAMPLE_UNIT_COUNT);
+    val_results_add_sample(MPAM_NODE_MEMORY, node_index, scenario_base + SWEEP_SCENARIO_STEP,
+                           partid, eff_step, ACS_SAMPLE_UNIT_COUNT);
+
+    return ACS_STATUS_PASS;
+}
+
+static void payload()
+{
+
+    uint32_t pe_index;
+    uint32_t node_index;
+    uint32_t cache_node_cnt;
+    uint32_t memory_node_cnt;
+    uint32_t sweep_node_cnt = 0;
+    uint32_t status;
+    uint16_t minmax_partid;
+    uint8_t *buf;
+    uint32_t num_pe = val_pe_get_num();
+
+    minmax_partid = DEFAULT_PARTID_MAX;
+    pe_index = val_pe_get_index_mpid(val_pe_get_mpid());
+    val_set_status(pe_index, RESULT_PENDING(TEST_NUM));
+    cache_node_cnt = val_node_get_total(MPAM_NODE_CACHE);
+    memory_node_cnt = val_node_get_total(MPAM_NODE_MEMORY);
+
+    /*
+     * Compute the number of MBWMAX or MBWMIN supported MPAM MEMORY nodes,
+     * and the min partition id supported among all MPAM nodes
+     */
+    for (node_index = 0; node_index < memory_node_cnt; node_index++) {
+
+        if (val_memory_supports_mbwmax(node_index) || val_memory_supports_mbwmin(node_index))
+            sweep_node_cnt++;
+
+        minmax_partid = GET_MIN_VALUE(minmax_partid,
+                                      val_node_get_partid(MPAM_NODE_MEMORY, node_index));
+    }
+
+    for (node_index = 0; node_index < cache_node_cnt; node_index++) {
+
+        minmax_partid = GET_MIN_VALUE(minmax_partid,
+                                      val_node_get_partid(MPAM_NODE_CACHE, node_index));
+    }
+
+    /* Skip this benchmark if no memory node regulates bandwidth */
+    if (sweep_node_cnt == 0) {
+        val_set_status(pe_index, RESULT_SKIP(TEST_NUM, 01));
+        return;
+    }
+
+    /* The aggressors run with the default PARTID, the swept PARTID must differ */
+    if (minmax_partid == DEFAULT_PARTID) {
+        val_set_status(pe_index, RESULT_SKIP(TEST_NUM, 02));
+        return;
+    }
+
+    /* Disable all types of partitioning for all cache nodes */
+    for (node_index = 0; node_index < cache_node_cnt; node_index++) {
+
+        if (val_cache_supports_cpor(node_index))
+            val_cache_configure_cpor(node_index, minmax_partid, 100);
+
+        if (val_cache_supports_ccap(node_index))
+            val_cache_configure_ccap(node_index, minmax_partid, 0, 100);
+    }
+
+    mpam2_el2_temp = val_sysreg_read(MPAM2_SYSREG);
+    config_mpam_params(minmax_partid);
+
+    for (node_index = 0; node_index < memory_node_cnt; node_index++) {
+
+        if (!val_memory_supports_mbwmax(node_index) && !val_memory_supports_mbwmin(node_index))
+            continue;
+
+        /* Disable MBWPBM partitioning for the current memory node_index */
+        if (val_memory_supports_mbwpbm(node_index))
+            val_memory_configure_mbwpbm(node_index, minmax_partid, 100);
+
+        /* Create a shared memcopy buffer from this memory node for every PE */
+        if (val_allocate_shared_memcpybuf(val_memory_get_base(node_index),
+                                          val_memory_get_size(node_index),
+                                          SWEEP_BUF_SIZE, num_pe) == 0) {
+            val_print(ACS_PRINT_ERR, "\n       Mem allocation for sweep buffers failed", 0x0);
+            val_set_status(pe_index, RESULT_FAIL(TEST_NUM, 01));
+            break;
+        }
+
+        if (val_prepare_shared_memcpybuf(num_pe, SWEEP_BUF_SIZE) != ACS_STATUS_PASS) {
+            val_mem_free_shared_memcpybuf(num_pe, SWEEP_BUF_SIZE);
+            val_set_status(pe_index, RESULT_FAIL(TEST_NUM, 02));
+            break;
+        }
+
+        buf = (uint8_t *)val_get_shared_memcpybuf(pe_index);
+        status = ACS_STATUS_PASS;
+
+        if (val_memory_supports_mbwmax(node_index))
+            status = sweep_control(SWEEP_MBWMAX, node_index, minmax_partid, buf);
+
+        if ((status != ACS_STATUS_ERR) && val_memory_supports_mbwmin(node_index))
+            status = sweep_control(SWEEP_MBWMIN, node_index, minmax_partid, buf);
+
+        val_mem_free_shared_memcpybuf(num_pe, SWEEP_BUF_SIZE);
+
+        if (status == ACS_STATUS_ERR) {
+            val_set_status(pe_index, RESULT_FAIL(TEST_NUM, 03));
+            break;
+        }
+    }
+
+    /* Restore MPAM2_EL2 settings */
+    val_sysreg_write(MPAM2_SYSREG, mpam2_el2_temp);
+
+    if (IS_RESULT_PENDING(val_get_status(pe_index)))
+        val_set_status(pe_index, RESULT_PASS(TEST_NUM, 01));
+
+    return;
+}
+
+uint32_t testb004_entry()
+{
+
+    uint32_t status = ACS_STATUS_FAIL;
+    uint32_t num_pe = 1;
+
+    status = val_initialize_test(TEST_NUM, TEST_DESC, num_pe);
+
+    /* This check is when user is forcing us to skip this test */
+    if (status != ACS_STATUS_SKIP)
+        val_run_test_payload(TEST_NUM, num_pe, payload, 0);
+
+    /* get the result from all PE and check for failure */
+    status = val_check_for_error(TEST_NUM, num_pe);
+
+    val_report_status(0, ACS_TEST_END(TEST_NUM));
+
+    return status;
+}
@@ -0,0 +1,317 @@
+/** @file
+ * Copyright (c) 2018, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#include "val/include/val_infra.h"
+#include "val/include/val_cache.h"
+#include "val/include/val_csu_monitor.h"
+#include "val/include/val_measurements.h"
+#include "val/include/val_node_infra.h"
+#include "val/include/val_mpam_hwreg_defs.h"
+#include "val/include/val_topology.h"
+#include "val/include/val_benchmark.h"
+#include "val/include/val_results.h"
+#include "val/include/val_samples.h"
+
+#define TEST_NUM   ACS_BENCH_TEST_NUM_BASE  +  5
+#define TEST_DESC  "Characterize CPBM portion capacity   "
+
+#define SWEEP_LINE_SIZE     64
+
+/* Upper bound on the number of portion counts swept per cache node */
+#define SWEEP_STEPS_MAX     16
+
+/* Number of passes made over the working set to load it in the cache */
+#define SWEEP_WARMUP_CNT    2
+
+/*
+ * Result scenarios reported for every step, the step being
+ * the number of portions allocated to the swept PARTID
+ */
+#define SWEEP_SCENARIO_REFILL       0x000
+#define SWEEP_SCENARIO_LATENCY      0x100
+#define SWEEP_SCENARIO_OCCUPANCY    0x200
+
+static uint64_t mpam2_el2_temp;
+
+static void config_mpam_params(uint16_t partid)
+{
+
+    uint64_t mpam2_el2 = mpam2_el2_temp;
+
+    /* Clear the PARTID_D & PMG_D bits in mpam2_el2 before writing to them */
+    mpam2_el2 = CLEAR_BITS_M_TO_N(mpam2_el2, MPAMn_ELx_PARTID_D_SHIFT+15, MPAMn_ELx_PARTID_D_SHIFT);
+    mpam2_el2 = CLEAR_BITS_M_TO_N(mpam2_el2, MPAMn_ELx_PMG_D_SHIFT+7, MPAMn_ELx_PMG_D_SHIFT);
+
+    /* Write the PARTID & DEFAULT PMG to mpam2_el2 to generate PE traffic */
+    mpam2_el2 |= (((uint64_t)DEFAULT_PMG << MPAMn_ELx_PMG_D_SHIFT) |
+                  ((uint64_t)partid << MPAMn_ELx_PARTID_D_SHIFT));
+
+    val_sysreg_write(MPAM2_SYSREG, mpam2_el2);
+}
+
+/* Read one word of every line of the buffer, in address order */
+static uint64_t touch_lines(volatile uint8_t *buf, uint64_t size)
+{
+
+    uint64_t offset;
+    uint64_t sum = 0;
+
+    for (offset = 0; offset < size; offset += SWEEP_LINE_SIZE)
+        sum += *(volatile uint64_t *)(buf + offset);
+
+    return sum;
+}
+
+/* Refill event of the cache level an MSC of this scope most likely is */
+static uint32_t refill_event(uint32_t node_index)
+{
+
+    switch (val_cache_get_scope(node_index)) {
+        case CACHE_SCOPE_PRIVATE:
+            return PMU_EVENT_L2D_CACHE_REFILL;
+        case CACHE_SCOPE_CLUSTER:
+            return PMU_EVENT_L3D_CACHE_REFILL;
+        default:
+            return PMU_EVENT_LL_CACHE_MISS_RD;
+    }
+}
+
+/**
+ * @brief   Give the swept PARTID 1..CPBM_WD portions of a cache node and
+ *          measure a working set sized to the nominal share at every step.
+ *          The default PARTID owns the remaining portions and thrashes them
+ *          between the warmup and the measured pass, so any refill of the
+ *          measured pass points to a share smaller than nominal or to
+ *          allocations leaking across portions.
+ */
+static void sweep_portions(uint32_t node_index, uint16_t partid,
+                           volatile uint8_t *buf, volatile uint8_t *thrash_buf)
+{
+
+    uint32_t step;
+    uint32_t step_cnt;
+    uint32_t index;
+    uint16_t num_portions;
+    uint16_t cpbm_width;
+    uint32_t cache_size;
+    uint32_t occupancy = 0;
+    uint8_t has_csumon;
+    uint64_t ws_size;
+    uint64_t refills;
+    uint64_t latency;
+    uint64_t start_time;
+    uint64_t end_time;
+    uint32_t event;
+
+    cpbm_width = val_cache_cpbm_width(node_index);
+    cache_size = val_cache_get_size(node_index);
+    step_cnt = GET_MIN_VALUE(cpbm_width, SWEEP_STEPS_MAX);
+    event = refill_event(node_index);
+    has_csumon = val_cache_supports_csumon(node_index) && val_cache_mon_count(node_index);
+
+    val_print(ACS_PRINT_TEST, "\n       CPBM sweep, node %d", node_index);
+    val_print(ACS_PRINT_TEST, ", CPBM_WD %d", cpbm_width);
+    val_print(ACS_PRINT_TEST, ", size %d KB", cache_size / 1024);
+    val_print(ACS_PRINT_TEST, ", PMU event 0x%x", event);
+
+    if (has_csumon)
+        val_csumon_config_monitor(node_index, partid, DEFAULT_PMG, 0);
+
+    for (step = 1; step <= step_cnt; step++) {
+        num_portions = (cpbm_width * step) / step_cnt;
+
+        /* The working set fits exactly the nominal share of the portions */
+        ws_size = ((uint64_t)cache_size * num_portions / cpbm_width) & ~(uint64_t)(SWEEP_LINE_SIZE - 1);
+        if (ws_size == 0)
+            continue;
+
+        val_cache_configure_cpor_range(node_index, partid, 0, num_portions);
+        if (num_portions < cpbm_width)
+            val_cache_configure_cpor_range(node_index, DEFAULT_PARTID, num_portions,
+                                           cpbm_width - num_portions);
+
+        /* Start every step from a cold working set */
+        val_data_cache_ops_by_range((addr_t)buf, ws_size, CLEAN_AND_INVALIDATE);
+        if (has_csumon)
+            val_csumon_reset_monitor(node_index, 0);
+
+        for (index = 0; index < SWEEP_WARMUP_CNT; index++)
+            touch_lines(buf, ws_size);
+
+        if (num_portions < cpbm_width) {
+            config_mpam_params(DEFAULT_PARTID);
+            touch_lines(thrash_buf, cache_size);
+            config_mpam_params(partid);
+        }
+
+        val_measurement_event_start(event);
+        start_time = val_measurement_read();
+        touch_lines(buf, ws_size);
+        end_time = val_measurement_read();
+        refills = val_measurement_event_read();
+        val_measurement_event_stop();
+
+        latency = (end_time - start_time) / (ws_size / SWEEP_LINE_SIZE);
+
+        if (has_csumon)
+            occupancy = val_csumon_storage_value(node_index, 0);
+
+        val_print(ACS_PRINT_TEST, "\n         portions %3d", num_portions);
+        val_print(ACS_PRINT_TEST, "  working set %6d KB", ws_size / 1024);
+        val_print(ACS_PRINT_TEST, "  refills %6ld", refills);
+        val_print(ACS_PRINT_TEST, "  latency %4ld cycles/line", latency);
+        if (has_csumon)
+            val_print(ACS_PRINT_TEST, "  occupancy %6d KB", occupancy / 1024);
+
+        val_results_add_sample(MPAM_NODE_CACHE, node_index, SWEEP_SCENARIO_REFILL + num_portions,
+                               partid, refills, ACS_SAMPLE_UNIT_COUNT);
+        val_results_add_sample(MPAM_NODE_CACHE, node_index, SWEEP_SCENARIO_LATENCY + num_portions,
+                               partid, latency, ACS_SAMPLE_UNIT_CYCLES);
+        if (has_csumon)
+            val_results_add_sample(MPAM_NODE_CACHE, node_index,
+                                   SWEEP_SCENARIO_OCCUPANCY + num_portions, partid, occupancy,
+                                   ACS_SAMPLE_UNIT_COUNT);
+    }
+
+    if (has_csumon)
+        val_csumon_restore_ctlreg(node_index, 0);
+
+    /* Give both PARTIDs the whole cache back */
+    val_cache_configure_cpor_range(node_index, partid, 0, cpbm_width);
+    val_cache_configure_cpor_range(node_index, DEFAULT_PARTID, 0, cpbm_width);
+}
+
+static void payload()
+{
+
+    uint32_t pe_index;
+    uint32_t node_index;
+    uint32_t cache_node_cnt;
+    uint32_t memory_node_cnt;
+    uint32_t sweep_node_cnt = 0;
+    uint32_t max_cache_size = 0;
+    uint16_t minmax_partid;
+    volatile uint8_t *buf;
+    volatile uint8_t *thrash_buf;
+
+    minmax_partid = DEFAULT_PARTID_MAX;
+    pe_index = val_pe_get_index_mpid(val_pe_get_mpid());
+    cache_node_cnt = val_node_get_total(MPAM_NODE_CACHE);
+    memory_node_cnt = val_node_get_total(MPAM_NODE_MEMORY);
+
+    /*
+     * Compute the number of CPOR supported MPAM CACHE nodes behind this PE,
+     * and the min partition id supported among all MPAM nodes
+     */
+    for (node_index = 0; node_index < cache_node_cnt; node_index++) {
+
+        if (val_cache_supports_cpor(node_index) && val_cache_cpbm_width(node_index) &&
+            val_topology_pe_shares_cache(pe_index, node_index)) {
+            sweep_node_cnt++;
+            max_cache_size = GET_MAX_VALUE(max_cache_size, val_cache_get_size(node_index));
+        }
+
+        minmax_partid = GET_MIN_VALUE(minmax_partid,
+                                      val_node_get_partid(MPAM_NODE_CACHE, node_index));
+    }
+
+    for (node_index = 0; node_index < memory_node_cnt; node_index++) {
+
+        minmax_partid = GET_MIN_VALUE(minmax_partid,
+                                      val_node_get_partid(MPAM_NODE_MEMORY, node_index));
+    }
+
+    /* Skip this benchmark if no CPOR supported cache node handles this PE traffic */
+    if ((sweep_node_cnt == 0) || (max_cache_size == 0)) {
+        val_set_status(pe_index, RESULT_SKIP(TEST_NUM, 01));
+        return;
+    }
+
+    /* The default PARTID thrashes the other portions, the swept PARTID must differ */
+    if (minmax_partid == DEFAULT_PARTID) {
+        val_set_status(pe_index, RESULT_SKIP(TEST_NUM, 02));
+        return;
+    }
+
+    buf = (volatile uint8_t *)val_allocate_buf(max_cache_size);
+    thrash_buf = (volatile uint8_t *)val_allocate_buf(max_cache_size);
+    if ((buf == NULL) || (thrash_buf == NULL)) {
+        val_print(ACS_PRINT_ERR, "\n       Mem allocation for sweep buffers failed", 0x0);
+        if (buf != NULL)
+            val_free_buf((void *)buf, max_cache_size);
+        if (thrash_buf != NULL)
+            val_free_buf((void *)thrash_buf, max_cache_size);
+        val_set_status(pe_index, RESULT_FAIL(TEST_NUM, 01));
+        return;
+    }
+
+    /* Zero the buffers, so the sweep does not pay for their first write */
+    val_mem_prepare_buf((void *)buf, max_cache_size);
+    val_mem_prepare_buf((void *)thrash_buf, max_cache_size);
+
+    mpam2_el2_temp = val_sysreg_read(MPAM2_SYSREG);
+    config_mpam_params(minmax_partid);
+
+    val_measurement_start();
+
+    for (node_index = 0; node_index < cache_node_cnt; node_index++) {
+
+        if (!val_cache_supports_cpor(node_index) || !val_cache_cpbm_width(node_index) ||
+            !val_topology_pe_shares_cache(pe_index, node_index))
+            continue;
+
+        /* Disable CCAP partitioning, so that only the portions limit the PARTID */
+        if (val_cache_supports_ccap(node_index)) {
+            val_cache_configure_ccap(node_index, minmax_partid, 0, 100);
+            val_cache_configure_ccap(node_index, DEFAULT_PARTID, 0, 100);
+        }
+
+        sweep_portions(node_index, minmax_partid, buf, thrash_buf);
+    }
+
+    val_measurement_stop();
+
+    /* Restore MPAM2_EL2 settings */
+    val_sysreg_write(MPAM2_SYSREG, mpam2_el2_temp);
+
+    val_free_buf((void *)buf, max_cache_size);
+    val_free_buf((void *)thrash_buf, max_cache_size);
+
+    val_set_status(pe_index, RESULT_PASS(TEST_NUM, 01));
+
+    return;
+}
+
+uint32_t testb005_entry()
+{
+
+    uint32_t status = ACS_STATUS_FAIL;
+    uint32_t num_pe = 1;
+
+    status = val_initialize_test(TEST_NUM, TEST_DESC, num_pe);
+
+    /* This check is when user is forcing us to skip this test */
+    if (status != ACS_STATUS_SKIP)
+        val_run_test_payload(TEST_NUM, num_pe, payload, 0);
+
+    /* get the result from all PE and check for failure */
+    status = val_check_for_error(TEST_NUM, num_pe);
+
+    val_report_status(0, ACS_TEST_END(TEST_NUM));
+
+    return status;
+}
@@ -0,0 +1,404 @@
+/** @file
+ * Copyright (c) 2018, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#include "val/include/val_infra.h"
+#include "val/include/val_cache.h"
+#include "val/include/val_memory.h"
+#include "val/include/val_node_infra.h"
+#include "val/include/val_mpam_hwreg_defs.h"
+#include "val/include/val_topology.h"
+#include "val/include/val_benchmark.h"
+#include "val/include/val_results.h"
+#include "val/include/val_samples.h"
+
+#define TEST_NUM   ACS_BENCH_TEST_NUM_BASE  +  6
+#define TEST_DESC  "Measure PARTID interference matrix   "
+
+/* Number of PARTIDs taking the victim and aggressor roles */
+#define MATRIX_PARTID_CNT   4
+
+/* Minimum size of the shared memcopy buffer of every PE */
+#define MATRIX_AGGR_BUF_SIZE    (16 * ONE_MB)
+
+#define MATRIX_LINE_SIZE    64
+
+/* Odd stride in lines, so that the victim walk defeats the prefetchers */
+#define MATRIX_LINE_STRIDE  97
+
+/* Number of passes over the victim working set per measurement */
+#define MATRIX_PASS_CNT     8
+
+/* Limits applied to the aggressor by the MBW and CCAP policies */
+#define MATRIX_AGGR_MBWMAX  25
+#define MATRIX_AGGR_CCAP    50
+
+typedef enum {
+    POLICY_NONE = 0,
+    POLICY_CPOR,
+    POLICY_CCAP,
+    POLICY_MBW,
+    POLICY_MAX
+} matrix_policy_t;
+
+static char8_t *policy_name[POLICY_MAX] = {
+    "no limits",
+    "CPOR split",
+    "CCAP aggressor 50%",
+    "MBWMAX aggressor 25%"
+};
+
+static uint64_t mpam2_el2_temp;
+static uint64_t slowdown[MATRIX_PARTID_CNT][MATRIX_PARTID_CNT];
+
+static void config_mpam_params(uint16_t partid)
+{
+
+    uint64_t mpam2_el2 = mpam2_el2_temp;
+
+    /* Clear the PARTID_D & PMG_D bits in mpam2_el2 before writing to them */
+    mpam2_el2 = CLEAR_BITS_M_TO_N(mpam2_el2, MPAMn_ELx_PARTID_D_SHIFT+15, MPAMn_ELx_PARTID_D_SHIFT);
+    mpam2_el2 = CLEAR_BITS_M_TO_N(mpam2_el2, MPAMn_ELx_PMG_D_SHIFT+7, MPAMn_ELx_PMG_D_SHIFT);
+
+    /* Write the PARTID & DEFAULT PMG to mpam2_el2 to generate PE traffic */
+    mpam2_el2 |= (((uint64_t)DEFAULT_PMG << MPAMn_ELx_PMG_D_SHIFT) |
+                  ((uint64_t)partid << MPAMn_ELx_PARTID_D_SHIFT));
+
+    val_sysreg_write(MPAM2_SYSREG, mpam2_el2);
+}
+
+/**
+ * @brief   Measure the mean access latency of the victim workload, a strided
+ *          walk over every line of the working set
+ * @return  Mean latency of one access in cycles
+ */
+static uint64_t measure_victim(volatile uint8_t *buf, uint64_t ws_size)
+{
+
+    uint32_t pass;
+    uint64_t line;
+    uint64_t line_cnt = ws_size / MATRIX_LINE_SIZE;
+    uint64_t start_time;
+    uint64_t end_time;
+    uint64_t sum = 0;
+
+    /* Load the working set before timing it */
+    for (line = 0; line < line_cnt; line++)
+        sum += *(volatile uint64_t *)(buf + line * MATRIX_LINE_SIZE);
+
+    start_time = val_measurement_read();
+    for (pass = 0; pass < MATRIX_PASS_CNT; pass++) {
+        for (line = 0; line < line_cnt; line++)
+            sum += *(volatile uint64_t *)(buf + ((line * MATRIX_LINE_STRIDE) % line_cnt)
+                                          * MATRIX_LINE_SIZE);
+    }
+    end_time = val_measurement_read();
+
+    (void)sum;
+    return (end_time - start_time) / (MATRIX_PASS_CNT * line_cnt);
+}
+
+/**
+ * @brief   Check if any MSC implements the controls used by a policy
+ */
+static uint8_t policy_supported(matrix_policy_t policy)
+{
+
+    uint32_t node_index;
+
+    if (policy == POLICY_NONE)
+        return 1;
+
+    if (policy == POLICY_MBW) {
+        for (node_index = 0; node_index < val_node_get_total(MPAM_NODE_MEMORY); node_index++) {
+            if (val_memory_supports_mbwmax(node_index))
+                return 1;
+        }
+        return 0;
+    }
+
+    for (node_index = 0; node_index < val_node_get_total(MPAM_NODE_CACHE); node_index++) {
+        if ((policy == POLICY_CPOR) && val_cache_supports_cpor(node_index) &&
+            (val_cache_cpbm_width(node_index) > 1))
+            return 1;
+        if ((policy == POLICY_CCAP) && val_cache_supports_ccap(node_index))
+            return 1;
+    }
+
+    return 0;
+}
+
+/**
+ * @brief   Lift every cache and memory bandwidth limit of a PARTID
+ */
+static void open_partid(uint16_t partid)
+{
+
+    uint32_t node_index;
+
+    for (node_index = 0; node_index < val_node_get_total(MPAM_NODE_CACHE); node_index++) {
+
+        if (val_cache_supports_cpor(node_index))
+            val_cache_configure_cpor_range(node_index, partid, 0, val_cache_cpbm_width(node_index));
+
+        if (val_cache_supports_ccap(node_index))
+            val_cache_configure_ccap(node_index, partid, HARDLIMIT_DIS, 100);
+    }
+
+    for (node_index = 0; node_index < val_node_get_total(MPAM_NODE_MEMORY); node_index++) {
+
+        if (val_memory_supports_mbwpbm(node_index))
+            val_memory_configure_mbwpbm(node_index, partid, 100);
+
+        if (val_memory_supports_mbwmin(node_index))
+            val_memory_configure_mbwmin(node_index, partid, 0);
+
+        if (val_memory_supports_mbwmax(node_index))
+            val_memory_configure_mbwmax(node_index, partid, HARDLIMIT_DIS, 100);
+    }
+}
+
+/**
+ * @brief   Apply a policy to a victim and aggressor PARTID pair. The limits
+ *          of a policy target the aggressor, when both roles share a PARTID
+ *          the victim is limited alike.
+ */
+static void apply_policy(matrix_policy_t policy, uint16_t victim, uint16_t aggressor)
+{
+
+    uint32_t node_index;
+    uint16_t cpbm_width;
+
+    open_partid(victim);
+    open_partid(aggressor);
+
+    for (node_index = 0; node_index < val_node_get_total(MPAM_NODE_CACHE); node_index++) {
+
+        if ((policy == POLICY_CPOR) && (victim != aggressor) && val_cache_supports_cpor(node_index)) {
+            cpbm_width = val_cache_cpbm_width(node_index);
+            if (cpbm_width > 1) {
+                val_cache_configure_cpor_range(node_index, victim, 0, cpbm_width / 2);
+                val_cache_configure_cpor_range(node_index, aggressor, cpbm_width / 2,
+                                               cpbm_width - (cpbm_width / 2));
+            }
+        }
+
+        if ((policy == POLICY_CCAP) && val_cache_supports_ccap(node_index))
+            val_cache_configure_ccap(node_index, aggressor, HARDLIMIT_EN, MATRIX_AGGR_CCAP);
+    }
+
+    for (node_index = 0; node_index < val_node_get_total(MPAM_NODE_MEMORY); node_index++) {
+
+        if ((policy == POLICY_MBW) && val_memory_supports_mbwmax(node_index))
+            val_memory_configure_mbwmax(node_index, aggressor, HARDLIMIT_EN, MATRIX_AGGR_MBWMAX);
+    }
+}
+
+static void payload()
+{
+
+    uint32_t pe_index;
+    uint32_t node_index;
+    uint32_t cache_node_cnt;
+    uint32_t memory_node_cnt;
+    uint32_t partid_cnt;
+    uint32_t victim;
+    uint32_t aggressor;
+    uint32_t policy;
+    uint32_t ws_size = 0;
+    uint32_t cache_node = 0;
+    uint8_t cache_shared = 0;
+    uint32_t aggr_node_type;
+    uint32_t aggr_node;
+    uint32_t mem_node = 0;
+    uint8_t mem_local = 0;
+    uint64_t buf_size;
+    uint16_t minmax_partid;
+    uint64_t alone;
+    uint64_t contended;
+    uint32_t result;
+    volatile uint8_t *buf;
+    uint32_t num_pe = val_pe_get_num();
+
+    minmax_partid = DEFAULT_PARTID_MAX;
+    pe_index = val_pe_get_index_mpid(val_pe_get_mpid());
+    cache_node_cnt = val_node_get_total(MPAM_NODE_CACHE);
+    memory_node_cnt = val_node_get_total(MPAM_NODE_MEMORY);
+
+    /*
+     * Compute the min partition id supported among all MPAM nodes, and size
+     * the victim working set to half of the largest cache behind this PE
+     */
+    for (node_index = 0; node_index < cache_node_cnt; node_index++) {
+
+        if (val_topology_pe_shares_cache(pe_index, node_index) &&
+            (val_cache_get_size(node_index) / 2 > ws_size)) {
+            ws_size = val_cache_get_size(node_index) / 2;
+            cache_node = node_index;
+            cache_shared = 1;
+        }
+
+        minmax_partid = GET_MIN_VALUE(minmax_partid,
+                                      val_node_get_partid(MPAM_NODE_CACHE, node_index));
+    }
+
+    /* Measure the first memory node local to this PE, node 0 if none is */
+    for (node_index = 0; node_index < memory_node_cnt; node_index++) {
+
+        if (!mem_local && val_topology_pe_is_memory_local(pe_index, node_index)) {
+            mem_node = node_index;
+            mem_local = 1;
+        }
+
+        minmax_partid = GET_MIN_VALUE(minmax_partid,
+                                      val_node_get_partid(MPAM_NODE_MEMORY, node_index));
+    }
+
+    partid_cnt = GET_MIN_VALUE((uint32_t)minmax_partid + 1, MATRIX_PARTID_CNT);
+    if (ws_size < MATRIX_LINE_SIZE)
+        ws_size = ONE_MB;
+
+    /* Skip this benchmark without two PARTIDs, a memory node or an aggressor PE */
+    if ((partid_cnt < 2) || (memory_node_cnt == 0) || (num_pe < 2)) {
+        val_set_status(pe_index, RESULT_SKIP(TEST_NUM, 01));
+        return;
+    }
+
+    /*
+     * The victim and the aggressors stream through the measured memory node,
+     * the victim working set lives in the shared buffer of this PE
+     */
+    buf_size = GET_MAX_VALUE((uint64_t)MATRIX_AGGR_BUF_SIZE, (uint64_t)ws_size);
+    if (val_allocate_shared_memcpybuf(val_memory_get_base(mem_node), val_memory_get_size(mem_node),
+                                      buf_size, num_pe) == 0) {
+        val_print(ACS_PRINT_ERR, "\n       Mem allocation for shared buffers failed, node %d",
+                  mem_node);
+        val_set_status(pe_index, RESULT_FAIL(TEST_NUM, 02));
+        return;
+    }
+
+    buf = (volatile uint8_t *)val_get_shared_memcpybuf(pe_index);
+    mpam2_el2_temp = val_sysreg_read(MPAM2_SYSREG);
+
+    if (val_prepare_shared_memcpybuf(num_pe, buf_size) != ACS_STATUS_PASS) {
+        result = RESULT_FAIL(TEST_NUM, 03);
+        goto cleanup;
+    }
+
+    val_print(ACS_PRINT_TEST, "\n       Memory node %d", mem_node);
+
+    val_measurement_start();
+
+    for (policy = 0; policy < POLICY_MAX; policy++) {
+
+        if (!policy_supported(policy))
+            continue;
+
+        /*
+         * Contend for the largest cache behind this PE unless bandwidth is
+         * regulated, the aggressors then run on the PEs in its scope
+         */
+        if ((policy != POLICY_MBW) && cache_shared) {
+            aggr_node_type = MPAM_NODE_CACHE;
+            aggr_node = cache_node;
+        } else {
+            aggr_node_type = MPAM_NODE_MEMORY;
+            aggr_node = mem_node;
+        }
+
+        for (victim = 0; victim < partid_cnt; victim++) {
+            for (aggressor = 0; aggressor < partid_cnt; aggressor++) {
+
+                apply_policy(policy, DEFAULT_PARTID + victim, DEFAULT_PARTID + aggressor);
+                config_mpam_params(DEFAULT_PARTID + victim);
+
+                alone = measure_victim(buf, ws_size);
+
+                if (val_benchmark_start_aggressors(aggr_node_type, aggr_node,
+                                                   DEFAULT_PARTID + aggressor,
+                                                   buf_size) == 0) {
+                    val_measurement_stop();
+                    result = RESULT_SKIP(TEST_NUM, 02);
+                    goto cleanup;
+                }
+
+                contended = measure_victim(buf, ws_size);
+
+                if (val_benchmark_stop_aggressors() != ACS_STATUS_PASS) {
+                    val_measurement_stop();
+                    result = RESULT_FAIL(TEST_NUM, 03);
+                    goto cleanup;
+                }
+
+                /* Slowdown of the victim in percent of its latency when running alone */
+                slowdown[victim][aggressor] = alone ? (contended * 100) / alone : 0;
+
+                val_results_add_sample(ACS_RESULTS_NODE_PE, ACS_RESULTS_ALL_NODES,
+                                       (policy << 8) | (victim << 4) | aggressor,
+                                       DEFAULT_PARTID + victim, slowdown[victim][aggressor],
+                                       ACS_SAMPLE_UNIT_COUNT);
+            }
+        }
+
+        /* One row per victim PARTID, one column per aggressor PARTID */
+        val_print(ACS_PRINT_TEST, "\n       Victim slowdown in percent, %a", (uint64_t)policy_name[policy]);
+        val_print(ACS_PRINT_TEST, "\n         victim/aggr", 0);
+        for (aggressor = 0; aggressor < partid_cnt; aggressor++)
+            val_print(ACS_PRINT_TEST, " %5d", DEFAULT_PARTID + aggressor);
+
+        for (victim = 0; victim < partid_cnt; victim++) {
+            val_print(ACS_PRINT_TEST, "\n         %11d", DEFAULT_PARTID + victim);
+            for (aggressor = 0; aggressor < partid_cnt; aggressor++)
+                val_print(ACS_PRINT_TEST, " %5ld", slowdown[victim][aggressor]);
+        }
+    }
+
+    val_measurement_stop();
+    result = RESULT_PASS(TEST_NUM, 01);
+
+cleanup:
+    /* Lift the limits of the PARTIDs and restore MPAM2_EL2 settings */
+    for (victim = 0; victim < partid_cnt; victim++)
+        open_partid(DEFAULT_PARTID + victim);
+
+    val_sysreg_write(MPAM2_SYSREG, mpam2_el2_temp);
+
+    val_mem_free_shared_memcpybuf(num_pe, buf_size);
+
+    val_set_status(pe_index, result);
+
+    return;
+}
+
+uint32_t testb006_entry()
+{
+
+    uint32_t status = ACS_STATUS_FAIL;
+    uint32_t num_pe = 1;
+
+    status = val_initialize_test(TEST_NUM, TEST_DESC, num_pe);
+
+    /* This check is when user is forcing us to skip this test */
+    if (status != ACS_STATUS_SKIP)
+        val_run_test_payload(TEST_NUM, num_pe, payload, 0);
+
+    /* get the result from all PE and check for failure */
+    status = val_check_for_error(TEST_NUM, num_pe);
+
+    val_report_status(0, ACS_TEST_END(TEST_NUM));
+
+    return status;
+}
@@ -19,6 +19,8 @@
 #include "val/include/val_cache.h"
 #include "val/include/val_node_infra.h"
 #include "val/include/val_mpam_hwreg_defs.h"
+#include "val/include/val_results.h"
+#include "val/include/val_samples.h"
 
 
 #define TEST_NUM   ACS_CACHE_TEST_NUM_BASE  +  6
@@ -175,6 +177,9 @@ static void payload()
             end_time = val_measurement_read();
             latency1[enabled_scenarios] = end_time - start_time;
             val_measurement_stop();
+            val_results_add_sample(MPAM_NODE_CACHE, ACS_RESULTS_ALL_NODES,
+                                   enabled_scenarios, partid1, latency1[enabled_scenarios],
+                                   ACS_SAMPLE_UNIT_CYCLES);
 
             val_print(ACS_PRINT_DEBUG, "     start_time          = 0x%lx\n", start_time);
             val_print(ACS_PRINT_DEBUG, "     end_time            = 0x%lx\n", end_time);
@@ -202,6 +207,9 @@ static void payload()
             end_time = val_measurement_read();
             latency2[enabled_scenarios++] = end_time - start_time;
             val_measurement_stop();
+            val_results_add_sample(MPAM_NODE_CACHE, ACS_RESULTS_ALL_NODES,
+                                   enabled_scenarios-1, partid2, latency2[enabled_scenarios-1],
+                                   ACS_SAMPLE_UNIT_CYCLES);
 
             val_print(ACS_PRINT_DEBUG, "     start_time          = 0x%lx\n", start_time);
             val_print(ACS_PRINT_DEBUG, "     end_time            = 0x%lx\n", end_time);
@@ -20,6 +20,8 @@
 #include "val/include/val_memory.h"
 #include "val/include/val_node_infra.h"
 #include "val/include/val_mpam_hwreg_defs.h"
+#include "val/include/val_results.h"
+#include "val/include/val_samples.h"
 
 #define TEST_NUM   ACS_MEMORY_TEST_NUM_BASE  +  1
 #define TEST_DESC  "Check MBWPBM Partitioning           "
@@ -171,6 +173,10 @@ static void payload()
                     return;
                 }
 
+                /* Zero the buffers, so the copy does not pay for their first write */
+                val_mem_prepare_buf(src_buf, buf_size);
+                val_mem_prepare_buf(dest_buf, buf_size);
+
                 /* Start mem copy and measure copy latency */
                 val_measurement_start();
                 start_time = val_measurement_read();
@@ -178,6 +184,9 @@ static void payload()
                 end_time = val_measurement_read();
                 latency[enabled_scenarios++][node_index] = end_time - start_time;
                 val_measurement_stop();
+                val_results_add_sample(MPAM_NODE_MEMORY, node_index, enabled_scenarios-1,
+                                       minmax_partid, latency[enabled_scenarios-1][node_index],
+                                       ACS_SAMPLE_UNIT_CYCLES);
 
                 val_print(ACS_PRINT_DEBUG, "     start_time          = 0x%lx\n", start_time);
                 val_print(ACS_PRINT_DEBUG, "     end_time            = 0x%lx\n", end_time);
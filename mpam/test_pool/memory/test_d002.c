@@ -21,6 +21,9 @@
 #include "val/include/val_memory.h"
 #include "val/include/val_node_infra.h"
 #include "val/include/val_mpam_hwreg_defs.h"
+#include "val/include/val_results.h"
+#include "val/include/val_samples.h"
+#include "val/include/val_topology.h"
 
 #define TEST_NUM   ACS_MEMORY_TEST_NUM_BASE  +  2
 #define TEST_DESC  "Check MBWMIN Partitioning           "
@@ -182,6 +185,7 @@ static void payload_primary()
     uint64_t end_time;
     uint32_t scenario_index;
     uint32_t scenario_cnt = 0;
+    uint32_t local_pe_cnt;
     uint64_t *latency_buf_ptr;
     uint32_t num_pe = val_pe_get_num();
 
@@ -249,12 +253,25 @@ static void payload_primary()
                 return;
             }
 
+            /* Zero every PE buffer in parallel, before any copy is measured */
+            if (val_prepare_shared_memcpybuf(num_pe, MEMCPY_BUF_SIZE) != ACS_STATUS_PASS) {
+                goto error_secondary_pending;
+            }
+
             /* Create buffers to perform memcopy (stream copy) */
             buf_size = MEMCPY_BUF_SIZE / 2;
             src_buf = (uint8_t *) val_get_shared_memcpybuf(primary_pe_index);
             dest_buf = src_buf + buf_size;
             val_mem_copy((void *)src_buf, (void *)dest_buf, buf_size);
 
+            /*
+             * Generate the contention from the secondary PEs local to this memory
+             * node, so that the traffic reaches its MSC. Use all the secondary
+             * PEs if none of them is local to the node.
+             */
+            local_pe_cnt = val_topology_get_memory_pes(node_index, NULL, 0)
+                           - val_topology_pe_is_memory_local(primary_pe_index, node_index);
+
             /****************************************************************
              *                        SCENARIO ONE
              ***************************************************************/
@@ -272,10 +289,17 @@ static void payload_primary()
             /* Create bandwidth contention on the current memory node */
             for (pe_index = 0; pe_index < num_pe; pe_index++) {
 
-                if (pe_index != primary_pe_index) {
-                    val_set_status(pe_index, RESULT_PENDING(TEST_NUM));
-                    val_execute_on_pe(pe_index, payload_secondary, 0);
+                if (pe_index == primary_pe_index)
+                    continue;
+
+                /* PEs remote to the node stay idle for this scenario */
+                if (local_pe_cnt && !val_topology_pe_is_memory_local(pe_index, node_index)) {
+                    val_set_status(pe_index, RESULT_PASS(TEST_NUM, 01));
+                    continue;
                 }
+
+                val_set_status(pe_index, RESULT_PENDING(TEST_NUM));
+                val_execute_on_pe(pe_index, payload_secondary, 0);
             }
 
             /* Start mem copy and measure copy latency */
@@ -285,6 +309,8 @@ static void payload_primary()
             end_time = val_measurement_read();
             *latency_buf_ptr = end_time - start_time;
             val_measurement_stop();
+            val_results_add_sample(MPAM_NODE_MEMORY, node_index, scenario_cnt,
+                                   minmax_partid, *latency_buf_ptr, ACS_SAMPLE_UNIT_CYCLES);
 
             contend_flag = 0;
             val_data_cache_ops_by_va((addr_t)&contend_flag, CLEAN);
@@ -311,10 +337,17 @@ static void payload_primary()
             /* Create bandwidth contention on the current memory node */
             for (pe_index = 0; pe_index < num_pe; pe_index++) {
 
-                if (pe_index != primary_pe_index) {
-                    val_set_status(pe_index, RESULT_PENDING(TEST_NUM));
-                    val_execute_on_pe(pe_index, payload_secondary, 0);
+                if (pe_index == primary_pe_index)
+                    continue;
+
+                /* PEs remote to the node stay idle for this scenario */
+                if (local_pe_cnt && !val_topology_pe_is_memory_local(pe_index, node_index)) {
+                    val_set_status(pe_index, RESULT_PASS(TEST_NUM, 01));
+                    continue;
                 }
+
+                val_set_status(pe_index, RESULT_PENDING(TEST_NUM));
+                val_execute_on_pe(pe_index, payload_secondary, 0);
             }
 
             /* Start mem copy and measure copy latency */
@@ -324,6 +357,8 @@ static void payload_primary()
             end_time = val_measurement_read();
             *latency_buf_ptr = end_time - start_time;
             val_measurement_stop();
+            val_results_add_sample(MPAM_NODE_MEMORY, node_index, scenario_cnt,
+                                   minmax_partid, *latency_buf_ptr, ACS_SAMPLE_UNIT_CYCLES);
 
             contend_flag = 0;
             val_data_cache_ops_by_va((addr_t)&contend_flag, CLEAN);
@@ -39,6 +39,9 @@ UINT64  g_stack_pointer;
 UINT64  g_exception_ret_addr;
 UINT64  g_ret_addr;
 SHELL_FILE_HANDLE g_acs_log_file_handle;
+SHELL_FILE_HANDLE g_acs_checkpoint_file_handle;
+SHELL_FILE_HANDLE g_acs_results_file_handle;
+SHELL_FILE_HANDLE g_acs_samples_file_handle;
 
 STATIC
 VOID
@@ -112,6 +115,42 @@ CreateMpamInfoTable (
     return val_mpam_create_info_table();
 }
 
+/* Records of the tests completed before a checkpoint resume are kept and
+ * appended to, otherwise the file starts empty like the sample file.
+ */
+VOID
+OpenResultsFile (
+    CONST CHAR16 *FileName,
+    BOOLEAN      Append
+)
+{
+
+    EFI_STATUS Status;
+
+    if (!Append)
+        ShellDeleteFileByName(FileName);
+
+    Status = ShellOpenFileByName(FileName, &g_acs_results_file_handle,
+                 EFI_FILE_MODE_WRITE | EFI_FILE_MODE_READ | EFI_FILE_MODE_CREATE, 0x0);
+    if (EFI_ERROR(Status)) {
+        Print(L"Failed to open results file %s\n", FileName);
+        g_acs_results_file_handle = NULL;
+        return;
+    }
+
+    if (Append) {
+        Status = ShellSetFilePosition(g_acs_results_file_handle, MAX_UINT64);
+        if (EFI_ERROR(Status)) {
+            Print(L"Failed to append to results file %s\n", FileName);
+            ShellCloseFile(&g_acs_results_file_handle);
+            g_acs_results_file_handle = NULL;
+            return;
+        }
+    }
+
+    val_results_init();
+}
+
 VOID
 FreeMpamAcsMem (
 )
@@ -127,12 +166,18 @@ HelpMsg (
     )
 {
 
-    Print (L"\nUsage: Mpam.efi [-v <n>] | [-f <filename>] | [-s] | [-skip <n>]\n"
+    Print (L"\nUsage: Mpam.efi [-v <n>] | [-f <filename>] | [-c <filename>] | [-j <filename>] | [-r <filename>] | [-p] | [-i] | [-s] | [-skip <n>]\n"
              "Options:\n"
              "-v      Verbosity of the Prints\n"
              "        1 shows all prints, 5 shows Errors\n"
              "        As per MPAM spec, 0 to 3\n"
              "-f      Name of the log file to record the test results in\n"
+             "-c      Name of the checkpoint file to resume an interrupted run from\n"
+             "        Completed tests are not run again, delete the file to start afresh\n"
+             "-j      Name of the file to record one JSON result record per test in\n"
+             "-r      Name of the binary file to record every raw timing sample in\n"
+             "-p      Keep secondary PEs powered on and parked between payloads\n"
+             "-i      Handle test interrupts natively instead of through the firmware\n"
              "-s      Enable the execution of secure tests\n"
              "-skip   Test(s) to be skipped\n"
              "        Refer to section 4 of MPAM_ACS_User_Guide\n"
@@ -144,6 +189,11 @@ HelpMsg (
 STATIC CONST SHELL_PARAM_ITEM ParamList[] = {
     {L"-v"    , TypeValue},    // -v    # Verbosity of the Prints. 1 shows all prints, 5 shows Errors
     {L"-f"    , TypeValue},    // -f    # Name of the log file to record the test results in.
+    {L"-c"    , TypeValue},    // -c    # Name of the checkpoint file to resume the run from.
+    {L"-j"    , TypeValue},    // -j    # Name of the file to record the JSON results in.
+    {L"-r"    , TypeValue},    // -r    # Name of the file to record the raw samples in.
+    {L"-p"    , TypeFlag},     // -p    # Binary Flag to park secondary PEs between payloads.
+    {L"-i"    , TypeFlag},     // -i    # Binary Flag to handle interrupts natively.
     {L"-s"    , TypeFlag},     // -s    # Binary Flag to enable the execution of secure tests.
     {L"-skip" , TypeValue},    // -skip # test(s) to skip execution
     {L"-help" , TypeFlag},     // -help # help : info about commands
@@ -169,9 +219,11 @@ ShellAppMain (
 
     LIST_ENTRY         *ParamPackage;
     CONST CHAR16       *CmdLineArg;
+    CONST CHAR16       *ResultsFileName;
     CHAR16             *ProbParam;
     UINT32             Status;
     UINT32             i,j=0;
+    UINT32             Resumed = 0;
     VOID               *branch_label;
 
     /* Process Command Line arguments */
@@ -231,6 +283,42 @@ ShellAppMain (
         }
     }
 
+    /* Options with Values */
+    CmdLineArg  = ShellCommandLineGetValue (ParamPackage, L"-c");
+    if (CmdLineArg == NULL) {
+        g_acs_checkpoint_file_handle = NULL;
+    } else {
+        Status = ShellOpenFileByName(CmdLineArg, &g_acs_checkpoint_file_handle,
+                     EFI_FILE_MODE_WRITE | EFI_FILE_MODE_READ | EFI_FILE_MODE_CREATE, 0x0);
+        if (EFI_ERROR(Status)) {
+            Print(L"Failed to open checkpoint file %s\n", CmdLineArg);
+            g_acs_checkpoint_file_handle = NULL;
+        }
+    }
+
+    /* Options with Values, the file is opened once the checkpoint is read */
+    ResultsFileName = ShellCommandLineGetValue (ParamPackage, L"-j");
+    g_acs_results_file_handle = NULL;
+
+    /* Options with Values */
+    CmdLineArg  = ShellCommandLineGetValue (ParamPackage, L"-r");
+    if (CmdLineArg == NULL) {
+        g_acs_samples_file_handle = NULL;
+    } else {
+        /* Start from an empty file, records of an earlier run must not remain */
+        ShellDeleteFileByName(CmdLineArg);
+        Status = ShellOpenFileByName(CmdLineArg, &g_acs_samples_file_handle,
+                     EFI_FILE_MODE_WRITE | EFI_FILE_MODE_READ | EFI_FILE_MODE_CREATE, 0x0);
+        if (EFI_ERROR(Status)) {
+            Print(L"Failed to open sample file %s\n", CmdLineArg);
+            g_acs_samples_file_handle = NULL;
+        } else if (val_samples_init()) {
+            Print(L"Failed to allocate the sample buffer, samples are not recorded\n");
+            ShellCloseFile(&g_acs_samples_file_handle);
+            g_acs_samples_file_handle = NULL;
+        }
+    }
+
     /* Options with Values */
     if ((ShellCommandLineGetFlag (ParamPackage, L"-help")) || (ShellCommandLineGetFlag (ParamPackage, L"-h"))) {
         HelpMsg();
@@ -262,6 +350,15 @@ ShellAppMain (
 
     val_allocate_shared_mem();
 
+    if (g_acs_checkpoint_file_handle) {
+        Resumed = val_checkpoint_init();
+        if (Resumed)
+            Print(L"\n Resuming from checkpoint, %d test(s) already completed \n", Resumed);
+    }
+
+    if (ResultsFileName != NULL)
+        OpenResultsFile(ResultsFileName, Resumed != 0);
+
     /*
      * Initialise exception vector, so any unexpected exception gets handled
      * by default MPAM exception handler
@@ -271,6 +368,16 @@ ShellAppMain (
     val_pe_initialize_default_exception_handler(val_pe_default_esr);
     FlushImage();
 
+    if (ShellCommandLineGetFlag (ParamPackage, L"-p")) {
+        if (val_pe_park_secondaries())
+            Print(L"\n Parking secondary PEs failed, using PSCI CPU_ON per payload \n");
+    }
+
+    if (ShellCommandLineGetFlag (ParamPackage, L"-i")) {
+        if (val_gic_fast_path_enable())
+            Print(L"\n Native interrupt path not available, using the firmware dispatch \n");
+    }
+
     Print(L"\n      ***  Starting CACHE PARTITION tests ***  \n");
     Status |= val_cache_execute_tests(val_pe_get_num());
 
@@ -288,6 +395,9 @@ ShellAppMain (
     Print(L"\n      ***  Starting MEMORY PARTITION tests ***  \n");
     Status |= val_memory_execute_tests(val_pe_get_num());
 
+    Print(L"\n      ***  Starting BENCHMARK tests ***  \n");
+    Status |= val_benchmark_execute_tests(val_pe_get_num());
+
 print_test_status:
     val_print(ACS_PRINT_TEST, "\n     ------------------------------------------------------- \n", 0);
     val_print(ACS_PRINT_TEST, "     Total Tests run  = %4d;", g_acs_tests_total);
@@ -295,12 +405,27 @@ print_test_status:
     val_print(ACS_PRINT_TEST, "  Tests Failed = %4d\n", g_acs_tests_fail);
     val_print(ACS_PRINT_TEST, "     --------------------------------------------------------- \n", 0);
 
+    val_gic_fast_path_disable();
+    val_pe_release_secondaries();
+    val_samples_flush();
     FreeMpamAcsMem();
 
     if (g_acs_log_file_handle) {
         ShellCloseFile(&g_acs_log_file_handle);
     }
 
+    if (g_acs_checkpoint_file_handle) {
+        ShellCloseFile(&g_acs_checkpoint_file_handle);
+    }
+
+    if (g_acs_results_file_handle) {
+        ShellCloseFile(&g_acs_results_file_handle);
+    }
+
+    if (g_acs_samples_file_handle) {
+        ShellCloseFile(&g_acs_samples_file_handle);
+    }
+
     Print(L"\n      *** MPAM tests complete. Reset the system. *** \n\n");
 
     val_pe_context_restore(arm64_write_sp(g_stack_pointer));
@@ -22,6 +22,8 @@
 #define TIMEOUT_MEDIUM  0x100000
 #define TIMEOUT_SMALL   0x1000
 
+#define PROXIMITY_DOMAIN_UNKNOWN    0xFFFFFFFF
+
 #define CLEAN_AND_INVALIDATE    0x1
 #define CLEAN                   0x2
 #define INVALIDATE              0x3
@@ -60,6 +62,7 @@ typedef struct {
     uint32_t    attr;
     uint64_t    mpidr;
     uint32_t    pmu_gsiv;
+    uint32_t    proximity_domain;
 } PE_INFO_ENTRY;
 
 typedef struct {
@@ -211,6 +214,7 @@ void pal_mpam_create_info_table(MPAM_INFO_TABLE **mpam_info_table);
 void pal_pe_call_smc(ARM_SMC_ARGS *args);
 void pal_pe_execute_payload(ARM_SMC_ARGS *args);
 uint32_t pal_pe_install_esr(uint32_t exception_type, void (*esr)(uint64_t, void *));
+uint32_t pal_pe_check_stack_guard(void);
 
 void pal_gic_create_info_table(GIC_INFO_TABLE *gic_info_table);
 uint32_t pal_gic_install_isr(uint32_t int_id, void (*isr)(void));
@@ -224,6 +228,8 @@ void pal_pmu_cycle_counter_stop();
 /* Generic PAL function declarations */
 void pal_print(char8_t *string, uint64_t data);
 void pal_print_raw(addr_t addr, char8_t *string, uint64_t data);
+void pal_results_print(char8_t *string, uint64_t data);
+void pal_results_flush(void);
 
 void *pal_mem_alloc(uint32_t size);
 void pal_mem_free(void *buffer);
@@ -237,18 +243,25 @@ void pal_mem_free_shared_latencybuf(uint32_t node_cnt);
 uint64_t pal_mem_get_shared_addr(void);
 uint64_t pal_mem_get_shared_memcpybuf_addr(void);
 uint64_t pal_mem_get_shared_latencybuf_addr(void);
+uint32_t pal_mem_get_shared_latencybuf_stride(void);
 void *pal_mem_allocate_buf(uint64_t size);
 void *pal_mem_allocate_address(uint64_t mem_base, uint64_t mem_size, uint64_t buf_size);
+void *pal_mem_allocate_code(uint64_t near, uint64_t size);
 void pal_mem_copy(void *source_addr,void *destination_addr, uint64_t length);
 void pal_mem_free_buf(void *buffer, uint64_t size);
 
 uint32_t pal_mmio_read(addr_t addr);
 void pal_mmio_write(addr_t addr, uint32_t data);
 
+uint32_t pal_checkpoint_read(void *buffer, uint32_t size);
+uint32_t pal_checkpoint_write(void *buffer, uint32_t size);
+uint32_t pal_samples_write(void *buffer, uint32_t size);
+
 void pal_pe_update_elr(void *context, uint64_t offset);
 uint64_t pal_pe_get_esr(void *context);
 uint64_t pal_pe_get_far(void *context);
 void pal_pe_data_cache_ops_by_va(addr_t addr, uint32_t type);
+void pal_pe_data_cache_ops_by_range(addr_t addr, uint64_t size, uint32_t type);
 
 #endif
 
@@ -0,0 +1,58 @@
+/** @file
+ * Copyright (c) 2018, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#ifndef __MPAM_ACS_BENCHMARK_H__
+#define __MPAM_ACS_BENCHMARK_H__
+
+/* Number of samples taken for every benchmark scenario */
+#define BENCH_SAMPLE_CNT    256
+
+/* Number of interrupts raised per MSC by the interrupt latency benchmarks */
+#define BENCH_INTR_CNT      64
+
+/* INTIDs below this value are PPIs (or SGIs), above are SPIs */
+#define BENCH_SPI_BASE      32
+
+/* Relative values reported by the characterization sweeps are in per mille */
+#define BENCH_PER_MILLE     1000
+
+typedef struct {
+    uint32_t    count;
+    uint64_t    min;
+    uint64_t    mean;
+    uint64_t    p50;
+    uint64_t    p90;
+    uint64_t    p99;
+    uint64_t    max;
+} VAL_BENCH_STATS_t;
+
+void val_benchmark_get_stats(uint64_t *samples, uint32_t count, VAL_BENCH_STATS_t *stats);
+void val_benchmark_report(char8_t *description, uint32_t node_type, uint32_t node_index,
+                          uint32_t scenario, uint32_t partid, VAL_BENCH_STATS_t *stats);
+uint64_t val_benchmark_ticks_to_ns(uint64_t ticks);
+uint32_t val_benchmark_start_aggressors(uint32_t node_type, uint32_t node_index,
+                                        uint16_t partid, uint64_t buf_size);
+uint32_t val_benchmark_stop_aggressors(void);
+
+uint32_t testb001_entry();
+uint32_t testb002_entry();
+uint32_t testb003_entry();
+uint32_t testb004_entry();
+uint32_t testb005_entry();
+uint32_t testb006_entry();
+
+#endif
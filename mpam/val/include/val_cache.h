@@ -30,8 +30,11 @@ uint16_t val_cache_cpbm_width(uint32_t node_index);
 uint8_t val_cache_cmax_width(uint32_t node_index);
 uint16_t val_cache_mon_count(uint32_t node_index);
 void val_cache_configure_cpor(uint32_t node_index, uint16_t partid, uint32_t cpbm_percentage);
+void val_cache_configure_cpor_range(uint32_t node_index, uint16_t partid,
+                                    uint16_t first_portion, uint16_t num_portions);
 void val_cache_configure_ccap(uint32_t node_index, uint16_t partid, uint8_t hardlim, uint32_t ccap_percentage);
 uint32_t val_cache_get_size(uint32_t node_index);
+uint32_t val_cache_get_scope(uint32_t node_index);
 
 uint32_t testc001_entry();
 uint32_t testc002_entry();
@@ -0,0 +1,45 @@
+/** @file
+ * Copyright (c) 2018, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#ifndef __MPAM_ACS_CHECKPOINT_H__
+#define __MPAM_ACS_CHECKPOINT_H__
+
+#define ACS_CHECKPOINT_SIGNATURE    0x4B43504D  /* "MPCK" */
+#define ACS_CHECKPOINT_REVISION     1
+#define ACS_CHECKPOINT_MAX_TESTS    (TEST_NUM_MASK + 1)
+#define ACS_CHECKPOINT_NO_TEST      0xFFFFFFFF
+
+/* Status reported for a test which was running when the previous invocation stopped */
+#define ACS_CHECKPOINT_STATUS_HANG  0xFF
+
+/*
+ * Checkpoint record persisted after every test. result[] holds the final status
+ * word of each completed test indexed by test number, 0 if the test has not completed.
+ */
+typedef struct {
+    uint32_t    signature;
+    uint32_t    revision;
+    uint32_t    num_pe;
+    uint32_t    current_test;
+    uint32_t    result[ACS_CHECKPOINT_MAX_TESTS];
+} VAL_CHECKPOINT_t;
+
+uint32_t val_checkpoint_get_result(uint32_t test_num);
+void val_checkpoint_start_test(uint32_t test_num);
+void val_checkpoint_end_test(uint32_t test_num, uint32_t status);
+
+#endif
@@ -24,6 +24,7 @@
 #define ACS_CSUMON_TEST_NUM_BASE    20
 #define ACS_INTR_TEST_NUM_BASE      30
 #define ACS_MEMORY_TEST_NUM_BASE    40
+#define ACS_BENCH_TEST_NUM_BASE     60
 
 #define STATE_BIT   28
 #define STATE_MASK  0xF
@@ -66,9 +67,15 @@ uint32_t val_initialize_test(uint32_t test_num, char8_t * desc, uint32_t num_pe)
 uint32_t val_check_for_error(uint32_t test_num, uint32_t num_pe);
 void val_run_test_payload(uint32_t test_num, uint32_t num_pe, void (*payload)(void), uint64_t test_input);
 void val_data_cache_ops_by_va(addr_t addr, uint32_t type);
+void val_data_cache_ops_by_range(addr_t addr, uint64_t size, uint32_t type);
+void val_data_cache_ops_batch_add(addr_t addr, uint64_t size, uint32_t type);
+void val_data_cache_ops_batch_flush(void);
 void val_memory_ops_issue_barrier(uint32_t type);
 void arm64_issue_dmb(void);
 void arm64_issue_dsb(void);
 void arm64_issue_isb(void);
+void arm64_send_event(void);
+void arm64_wait_for_event(void);
+void arm64_zero_range(uint64_t addr, uint64_t size);
 
 #endif
@@ -18,6 +18,28 @@
 #ifndef __MPAM_ACS_GIC_H__
 #define __MPAM_ACS_GIC_H__
 
+/* INTIDs above this range are special (e.g. 1023 is spurious) */
+#define GIC_MAX_INTID       1020
+#define GIC_INTID_MASK      0xFFFFFF
+
+/* Native interrupt path, see val_gic_fast_path_enable */
+#define GIC_NATIVE_PATH_EL      2
+#define GIC_VECTOR_ENTRIES      16
+#define GIC_VECTOR_ENTRY_SIZE   0x80
+#define GIC_VECTOR_IRQ          0x280   /* Current EL with SP_ELx, IRQ */
+#define GIC_VECTOR_CHAIN        0x800   /* Hand-off to the firmware IRQ vector */
+#define GIC_VECTOR_SIZE         0x1000
+/* B reaches +/-128 MB, less the size of the vector page */
+#define GIC_BRANCH_RANGE        ((1ULL << 27) - GIC_VECTOR_SIZE)
+
+/* A64 instructions written into the native vector page */
+#define A64_B(offset)           (0x14000000 | (((uint64_t)(offset) >> 2) & 0x3FFFFFF))
+#define A64_LDR_X0_LITERAL(off) (0x58000000 | (((off) >> 2) << 5))
+#define A64_STP_X0_X1_PRE       0xA9BF07E0  /* stp x0, x1, [sp, #-16]! */
+#define A64_LDP_X0_X1_POST      0xA8C107E0  /* ldp x0, x1, [sp], #16 */
+#define A64_BR_X0               0xD61F0000
+#define A64_NOP                 0xD503201F
+
 uint32_t g001_entry(uint32_t num_pe);
 
 #endif
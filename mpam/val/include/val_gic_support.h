@@ -23,7 +23,9 @@ typedef enum {
     ICH_MISR_EL2,
     ICC_IGRPEN1_EL1,
     ICC_BPR1_EL1,
-    ICC_PMR_EL1
+    ICC_PMR_EL1,
+    ICC_IAR1_EL1,
+    ICC_EOIR1_EL1
 } MPAM_ACS_GIC_REGS;
 
 uint64_t val_gic_reg_read(uint32_t reg_id);
@@ -31,10 +33,17 @@ void     val_gic_reg_write(uint32_t reg_id, uint64_t write_data);
 
 uint64_t GicReadIchHcr(void);
 uint64_t GicReadIchMisr(void);
+uint64_t GicReadIccIar1(void);
+uint64_t GicReadIccHppir1(void);
 
 void GicWriteIchHcr(uint64_t write_data);
 void GicWriteIccIgrpen1(uint64_t write_data);
 void GicWriteIccBpr1(uint64_t write_data);
 void GicWriteIccPmr(uint64_t write_data);
+void GicWriteIccEoir1(uint64_t write_data);
+
+void ValGicIrqEntry(void);
+void ValGicSyncInstructions(void);
+uint64_t val_gic_irq_dispatch(void);
 
 #endif
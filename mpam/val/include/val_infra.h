@@ -28,11 +28,13 @@ typedef struct {
     uint64_t    data0;
     uint64_t    data1;
     uint32_t    status;
+    uint32_t    mailbox;
 } VAL_SHARED_MEM_t;
 
 void val_report_status(uint32_t id, uint32_t status);
 void val_set_status(uint32_t index, uint32_t status);
 uint32_t val_get_status(uint32_t id);
+void val_set_status_all(uint32_t num_pe, uint32_t status);
 
 #endif
 
@@ -52,8 +52,14 @@ void val_set_test_data(uint32_t index, uint64_t addr, uint64_t test_data);
 void val_get_test_data(uint32_t index, uint64_t *data0, uint64_t *data1);
 uint64_t val_get_shared_memcpybuf(uint32_t pe_index);
 void val_mem_free_shared_memcpybuf(uint32_t num_pe, uint64_t buf_size);
+uint32_t val_prepare_shared_memcpybuf(uint32_t num_pe, uint64_t buf_size);
+void val_mem_prepare_buf(void *buf, uint64_t size);
 void val_mem_free_shared_latencybuf(uint32_t node_cnt);
 uint64_t *val_get_shared_latencybuf(uint32_t scenario_index, uint32_t node_index);
+uint32_t val_checkpoint_init(void);
+void val_results_init(void);
+uint32_t val_samples_init(void);
+void val_samples_flush(void);
 
 /* VAL PE APIs */
 uint32_t val_pe_create_info_table(uint64_t *pe_info_table);
@@ -65,6 +71,8 @@ uint64_t val_pe_get_mpid(void);
 uint32_t val_pe_get_index_mpid(uint64_t mpid);
 
 void val_execute_on_pe(uint32_t index, void (*payload)(void), uint64_t args);
+uint32_t val_pe_park_secondaries(void);
+void val_pe_release_secondaries(void);
 void val_suspend_pe(uint32_t power_state, uint64_t entry, uint32_t context_id);
 
 /* GIC VAL APIs */
@@ -76,6 +84,7 @@ uint32_t val_cache_execute_tests(uint32_t num_pe);
 uint32_t val_csumon_execute_tests(uint32_t num_pe);
 uint32_t val_interrupts_execute_tests(uint32_t num_pe);
 uint32_t val_memory_execute_tests(uint32_t num_pe);
+uint32_t val_benchmark_execute_tests(uint32_t num_pe);
 
 typedef enum {
     GIC_INFO_VERSION=1,
@@ -93,11 +102,19 @@ void val_gic_free_info_table(void);
 uint32_t val_gic_install_isr(uint32_t int_id, void (*isr)(void));
 uint32_t val_gic_route_interrupt_to_pe(uint32_t int_id, uint64_t mpidr);
 uint32_t val_gic_end_of_interrupt(uint32_t int_id);
+uint32_t val_gic_fast_path_enable(void);
+void val_gic_fast_path_disable(void);
+uint64_t val_gic_get_irq_entry_time(void);
 void val_gic_write_ispendreg(uint32_t intr_id);
 
 /* MEASUREMENTS VAL APIs */
 void val_measurement_start();
 void val_measurement_stop();
 uint64_t val_measurement_read();
+uint64_t val_measurement_get_counter();
+uint64_t val_measurement_get_counter_freq();
+void val_measurement_event_start(uint32_t event);
+void val_measurement_event_stop();
+uint64_t val_measurement_event_read();
 
 #endif
@@ -22,11 +22,26 @@ typedef enum {
     PMCR_EL0 = 1,
     PMCCNTR_EL0,
     PMCCFILTR_EL0,
-    PMCNTENSET_EL0
+    PMCNTENSET_EL0,
+    PMCNTENCLR_EL0,
+    PMEVTYPER0_EL0,
+    PMEVCNTR0_EL0
 } MPAM_ACS_PMU_REGS;
 
+/* Common architectural PMU events counted by event counter 0 */
+#define PMU_EVENT_L2D_CACHE_REFILL  0x17
+#define PMU_EVENT_L3D_CACHE_REFILL  0x2A
+#define PMU_EVENT_LL_CACHE_MISS_RD  0x37
+
+/* Count the event at EL2 as well, as PMCCFILTR_EL0 does for cycles */
+#define PMEVTYPER_NSH_EN_BIT        27
+#define PMCNTEN_P0_BIT              0
+
 void val_measurement_start();
 void val_measurement_stop();
 
+uint64_t ArmReadCntPct(void);
+uint64_t ArmReadCntFrq(void);
+
 #endif
 
@@ -62,6 +62,7 @@ void     val_node_clear_intr(uint8_t node_type, uint32_t node_index);
 void     val_node_restore_ecr(uint8_t node_type, uint32_t node_index);
 void     val_node_generate_psr_error(uint8_t node_type, uint32_t node_index);
 uint8_t  val_node_supports_mon(uint8_t node_type, uint32_t node_index);
+void     val_node_setup_msmon_oflow(uint32_t node_index, uint16_t mon_count);
 void     val_node_generate_msmon_oflow_error(uint32_t node_index, uint16_t mon_count);
 void     val_node_generate_msmon_config_error(uint8_t node_type, uint32_t node_index, uint16_t mon_count);
 void     val_node_generate_msr_error(uint8_t node_type, uint32_t node_index, uint16_t mon_count);
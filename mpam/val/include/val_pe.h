@@ -21,6 +21,13 @@
 #define MAX_NUM_PE_LEVEL0   0x8
 #define MAX_NUM_PE_LEVEL2   (2 << 27)
 
+/* Mailbox states of a secondary PE parked between payloads */
+#define PE_MAILBOX_IDLE      0x0
+#define PE_MAILBOX_DISPATCH  0x1
+#define PE_MAILBOX_BUSY      0x2
+#define PE_MAILBOX_EXIT      0x3
+#define PE_MAILBOX_OFF       0x4
+
 /* AARCH64 processor exception types */
 #define EXCEPT_AARCH64_SYNC     0
 #define EXCEPT_AARCH64_IRQ      1
@@ -225,6 +232,7 @@ uint64_t val_pe_get_esr(void *context);
 uint64_t val_pe_get_far(void *context);
 void val_pe_context_save(uint64_t sp, uint64_t elr);
 void val_pe_initialize_default_exception_handler(void (*esr)(uint64_t, void *));
+uint32_t val_pe_install_esr(uint32_t exception_type, void (*esr)(uint64_t, void *));
 void val_pe_context_restore(uint64_t sp);
 void val_pe_default_esr(uint64_t interrupt_type, void *context);
 void val_pe_cache_clean_range(uint64_t start_addr, uint64_t length);
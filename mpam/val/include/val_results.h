@@ -0,0 +1,56 @@
+/** @file
+ * Copyright (c) 2018, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#ifndef __MPAM_ACS_RESULTS_H__
+#define __MPAM_ACS_RESULTS_H__
+
+#define ACS_RESULTS_MAX_SAMPLES     64
+
+/* Node index of a sample measured with all nodes of a type configured alike */
+#define ACS_RESULTS_ALL_NODES       0xFFFFFFFF
+
+/* Node type of a sample measured on the PE itself, not on an MSC */
+#define ACS_RESULTS_NODE_PE         0xFF
+
+/* Statistic a sample holds when it summarises a distribution */
+typedef enum {
+    ACS_RESULTS_STAT_NONE = 0,
+    ACS_RESULTS_STAT_MIN,
+    ACS_RESULTS_STAT_MEAN,
+    ACS_RESULTS_STAT_P50,
+    ACS_RESULTS_STAT_P90,
+    ACS_RESULTS_STAT_P99,
+    ACS_RESULTS_STAT_MAX
+} ACS_RESULTS_STAT_e;
+
+typedef struct {
+    uint32_t    node_type;
+    uint32_t    node_index;
+    uint32_t    scenario;
+    uint32_t    partid;
+    uint32_t    stat;
+    uint64_t    value;
+} VAL_RESULTS_SAMPLE_t;
+
+void val_results_start_test(uint32_t test_num);
+void val_results_add_sample(uint32_t node_type, uint32_t node_index, uint32_t scenario,
+                            uint32_t partid, uint64_t value, uint32_t unit);
+void val_results_add_stat(uint32_t node_type, uint32_t node_index, uint32_t scenario,
+                          uint32_t partid, uint32_t stat, uint64_t value);
+void val_results_end_test(uint32_t test_num, uint32_t status);
+
+#endif
@@ -0,0 +1,69 @@
+/** @file
+ * Copyright (c) 2018, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#ifndef __MPAM_ACS_SAMPLES_H__
+#define __MPAM_ACS_SAMPLES_H__
+
+#define ACS_SAMPLES_SIGNATURE   0x5253504D  /* "MPSR" */
+#define ACS_SAMPLES_REVISION    2
+
+/* Unit of VAL_SAMPLE_t.value */
+#define ACS_SAMPLE_UNIT_COUNT   0   /* count, size or ratio, defined by the test scenario */
+#define ACS_SAMPLE_UNIT_CYCLES  1   /* PMU cycles */
+#define ACS_SAMPLE_UNIT_TICKS   2   /* CNTPCT_EL0 ticks at header.counter_freq Hz */
+
+/* Capacity of the preallocated sample buffer, samples beyond it are dropped */
+#define ACS_SAMPLES_MAX         (64 * 1024)
+
+/*
+ * Layout of the raw sample file, all fields little endian:
+ *   VAL_SAMPLES_HEADER_t               at offset 0
+ *   VAL_SAMPLE_t[header.sample_cnt]    at offset header.header_size
+ * Counter values are CNTPCT_EL0 ticks at header.counter_freq Hz.
+ */
+typedef struct {
+    uint32_t    signature;
+    uint16_t    revision;
+    uint16_t    header_size;
+    uint16_t    sample_size;
+    uint16_t    num_pe;
+    uint32_t    sample_cnt;
+    uint32_t    dropped_cnt;
+    uint32_t    reserved;
+    uint64_t    counter_freq;
+} VAL_SAMPLES_HEADER_t;
+
+typedef struct {
+    uint16_t    test_num;
+    uint16_t    scenario;
+    uint16_t    pe_index;
+    uint16_t    partid;
+    uint8_t     node_type;      /* MPAM_NODE_CACHE, MPAM_NODE_MEMORY or ACS_RESULTS_NODE_PE */
+    uint8_t     unit;           /* ACS_SAMPLE_UNIT_* */
+    uint8_t     reserved[2];
+    uint32_t    node_index;     /* ACS_RESULTS_ALL_NODES if all nodes of the type */
+    uint64_t    value;          /* measured value, in the unit of the sample */
+    uint64_t    counter;        /* system counter when the sample was recorded */
+} VAL_SAMPLE_t;
+
+void val_samples_start_test(uint32_t test_num);
+void val_samples_record(uint32_t node_type, uint32_t node_index, uint32_t scenario,
+                        uint32_t pe_index, uint32_t partid, uint64_t value, uint32_t unit);
+void val_samples_record_array(uint32_t node_type, uint32_t node_index, uint32_t scenario,
+                              uint32_t partid, uint64_t *values, uint32_t count, uint32_t unit);
+
+#endif
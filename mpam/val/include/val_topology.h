@@ -0,0 +1,35 @@
+/** @file
+ * Copyright (c) 2018, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#ifndef __MPAM_ACS_TOPOLOGY_H__
+#define __MPAM_ACS_TOPOLOGY_H__
+
+#define MPIDR_AFF0(mpidr)   ((mpidr) & 0xFF)
+#define MPIDR_AFF1(mpidr)   (((mpidr) >> 8) & 0xFF)
+#define MPIDR_AFF2(mpidr)   (((mpidr) >> 16) & 0xFF)
+#define MPIDR_AFF3(mpidr)   (((mpidr) >> 32) & 0xFF)
+
+/* Cluster id in the format of CACHE_NODE_INFO.scope_index for cluster scope caches */
+#define MPIDR_CLUSTER_ID(mpidr)  ((MPIDR_AFF3(mpidr) << 16) | (MPIDR_AFF2(mpidr) << 8) | MPIDR_AFF1(mpidr))
+
+uint8_t  val_topology_pe_shares_cache(uint32_t pe_index, uint32_t node_index);
+uint8_t  val_topology_pe_is_memory_local(uint32_t pe_index, uint32_t node_index);
+uint32_t val_topology_get_cache_pes(uint32_t node_index, uint32_t *pe_list, uint32_t max_cnt);
+uint32_t val_topology_get_memory_pes(uint32_t node_index, uint32_t *pe_list, uint32_t max_cnt);
+uint32_t val_topology_get_sibling_cnt(uint32_t pe_index, uint32_t node_scope);
+
+#endif
@@ -0,0 +1,312 @@
+/** @file
+ * Copyright (c) 2018, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#include "include/val_infra.h"
+#include "include/val_node_infra.h"
+#include "include/val_mpam_hwreg_defs.h"
+#include "include/val_topology.h"
+#include "include/val_benchmark.h"
+#include "include/val_results.h"
+
+static uint8_t g_bench_contend_flag;
+static uint64_t g_bench_contend_buf_size;
+
+/**
+ * @brief   This API will execute all MPAM benchmarks. The benchmarks do not
+ *          check compliance, they report the distribution of the measured
+ *          costs so that regressions between platforms can be caught.
+ *          1. Caller       -  Application layer.
+ *          2. Prerequisite -  val_pe_create_info_table, val_allocate_shared_mem
+ * @param   num_pe - the number of PE to run these tests on.
+ * @return  Consolidated status of all the tests run.
+ */
+uint32_t val_benchmark_execute_tests(uint32_t num_pe)
+{
+
+    uint32_t status, i;
+
+    for (i=0 ; i< MAX_TEST_SKIP_NUM ; i++) {
+        if (g_skip_test_num[i] == ACS_BENCH_TEST_NUM_BASE) {
+            val_print(ACS_PRINT_TEST, "\n USER Override - Skipping all benchmarks \n", 0);
+            return ACS_STATUS_SKIP;
+        }
+    }
+
+    status = testb001_entry();
+    status |= testb002_entry();
+    status |= testb003_entry();
+    status |= testb004_entry();
+    status |= testb005_entry();
+    status |= testb006_entry();
+
+    if (status != ACS_STATUS_PASS)
+        val_print(ACS_PRINT_TEST, "\n      *** One or more benchmarks have failed... *** \n", 0);
+    else
+        val_print(ACS_PRINT_TEST, "\n      All benchmarks have passed!! \n", 0);
+
+    return status;
+}
+
+/**
+ * @brief   This API computes the distribution of a set of samples.
+ *          The samples are sorted in place.
+ *          1. Caller       -  Test Suite
+ *          2. Prerequisite -  None
+ * @param   samples - array of measured values
+ * @param   count   - number of entries in samples
+ * @param   stats   - filled with the distribution of the samples
+ * @return  None
+ */
+void val_benchmark_get_stats(uint64_t *samples, uint32_t count, VAL_BENCH_STATS_t *stats)
+{
+
+    uint32_t i, j;
+    uint64_t value;
+    uint64_t sum = 0;
+
+    stats->count = count;
+    stats->min = stats->mean = stats->max = 0;
+    stats->p50 = stats->p90 = stats->p99 = 0;
+
+    if (count == 0)
+        return;
+
+    /* Insertion sort, the sample sets are small */
+    for (i = 1; i < count; i++) {
+        value = samples[i];
+        for (j = i; (j > 0) && (samples[j-1] > value); j--)
+            samples[j] = samples[j-1];
+        samples[j] = value;
+    }
+
+    for (i = 0; i < count; i++)
+        sum += samples[i];
+
+    stats->min = samples[0];
+    stats->max = samples[count-1];
+    stats->mean = sum / count;
+    stats->p50 = samples[(count - 1) * 50 / 100];
+    stats->p90 = samples[(count - 1) * 90 / 100];
+    stats->p99 = samples[(count - 1) * 99 / 100];
+}
+
+/**
+ * @brief   This API prints the distribution of a benchmark scenario and
+ *          records it in the structured results of the test in progress.
+ *          1. Caller       -  Test Suite, primary PE only
+ *          2. Prerequisite -  val_benchmark_get_stats
+ * @param   description - name of the scenario
+ * @param   node_type   - MPAM_NODE_CACHE, MPAM_NODE_MEMORY or ACS_RESULTS_NODE_PE
+ * @param   node_index  - index of the node measured, ACS_RESULTS_ALL_NODES if none
+ * @param   scenario    - index of the scenario within the test
+ * @param   partid      - PARTID the scenario ran with
+ * @param   stats       - distribution of the scenario
+ * @return  None
+ */
+void val_benchmark_report(char8_t *description, uint32_t node_type, uint32_t node_index,
+                          uint32_t scenario, uint32_t partid, VAL_BENCH_STATS_t *stats)
+{
+
+    val_print(ACS_PRINT_TEST, "\n       %a", (uint64_t)description);
+    if (node_index != ACS_RESULTS_ALL_NODES)
+        val_print(ACS_PRINT_TEST, ", node %d", node_index);
+    val_print(ACS_PRINT_TEST, "\n         samples = %d", stats->count);
+    val_print(ACS_PRINT_TEST, "  min = %ld", stats->min);
+    val_print(ACS_PRINT_TEST, "  mean = %ld", stats->mean);
+    val_print(ACS_PRINT_TEST, "  p50 = %ld", stats->p50);
+    val_print(ACS_PRINT_TEST, "  p90 = %ld", stats->p90);
+    val_print(ACS_PRINT_TEST, "  p99 = %ld", stats->p99);
+    val_print(ACS_PRINT_TEST, "  max = %ld", stats->max);
+
+    val_results_add_stat(node_type, node_index, scenario, partid,
+                         ACS_RESULTS_STAT_MIN, stats->min);
+    val_results_add_stat(node_type, node_index, scenario, partid,
+                         ACS_RESULTS_STAT_MEAN, stats->mean);
+    val_results_add_stat(node_type, node_index, scenario, partid,
+                         ACS_RESULTS_STAT_P50, stats->p50);
+    val_results_add_stat(node_type, node_index, scenario, partid,
+                         ACS_RESULTS_STAT_P90, stats->p90);
+    val_results_add_stat(node_type, node_index, scenario, partid,
+                         ACS_RESULTS_STAT_P99, stats->p99);
+    val_results_add_stat(node_type, node_index, scenario, partid,
+                         ACS_RESULTS_STAT_MAX, stats->max);
+}
+
+/**
+ * @brief   This API converts a system counter interval to nanoseconds
+ *          1. Caller       -  Test Suite
+ *          2. Prerequisite -  None
+ * @param   ticks - interval in system counter ticks
+ * @return  interval in nanoseconds, 0 if the counter frequency is not set
+ */
+uint64_t val_benchmark_ticks_to_ns(uint64_t ticks)
+{
+
+    uint64_t freq = val_measurement_get_counter_freq();
+
+    if (freq == 0)
+        return 0;
+
+    return (ticks * 1000000000) / freq;
+}
+
+/**
+ * @brief   Payload run on every aggressor PE. It streams copies through its
+ *          shared memcopy buffer with the input PARTID, until the aggressors
+ *          are stopped by val_benchmark_stop_aggressors.
+ *
+ * @param   partid  - PARTID the aggressor traffic is generated with
+ *
+ * @return  None
+ */
+static void val_benchmark_aggressor(uint64_t partid)
+{
+
+    uint32_t pe_index;
+    uint64_t buf_size;
+    uint64_t mpam2_el2;
+    uint64_t mpam2_aggr;
+    uint8_t *src_buf;
+
+    pe_index = val_pe_get_index_mpid(val_pe_get_mpid());
+
+    val_data_cache_ops_by_va((addr_t)&g_bench_contend_buf_size, INVALIDATE);
+    buf_size = g_bench_contend_buf_size / 2;
+    src_buf = (uint8_t *)val_get_shared_memcpybuf(pe_index);
+
+    mpam2_el2 = val_sysreg_read(MPAM2_SYSREG);
+
+    /* Clear the PARTID_D & PMG_D bits in mpam2_el2 before writing to them */
+    mpam2_aggr = CLEAR_BITS_M_TO_N(mpam2_el2, MPAMn_ELx_PARTID_D_SHIFT+15, MPAMn_ELx_PARTID_D_SHIFT);
+    mpam2_aggr = CLEAR_BITS_M_TO_N(mpam2_aggr, MPAMn_ELx_PMG_D_SHIFT+7, MPAMn_ELx_PMG_D_SHIFT);
+    mpam2_aggr |= (((uint64_t)DEFAULT_PMG << MPAMn_ELx_PMG_D_SHIFT) |
+                   ((partid & 0xFFFF) << MPAMn_ELx_PARTID_D_SHIFT));
+
+    val_sysreg_write(MPAM2_SYSREG, mpam2_aggr);
+
+    while (g_bench_contend_flag) {
+        val_mem_copy((void *)src_buf, (void *)(src_buf + buf_size), buf_size);
+        val_data_cache_ops_by_va((addr_t)&g_bench_contend_flag, INVALIDATE);
+    }
+
+    /* Restore MPAM2_EL2 settings */
+    val_sysreg_write(MPAM2_SYSREG, mpam2_el2);
+
+    val_set_status(pe_index, RESULT_PASS(0, 0));
+}
+
+/**
+ * @brief   Check if a PE is within the scope of an MPAM node, i.e. it shares
+ *          a cache node or is local to a memory node
+ */
+static uint8_t val_benchmark_pe_in_scope(uint32_t node_type, uint32_t pe_index, uint32_t node_index)
+{
+
+    if (node_type == MPAM_NODE_CACHE)
+        return val_topology_pe_shares_cache(pe_index, node_index);
+
+    return val_topology_pe_is_memory_local(pe_index, node_index);
+}
+
+/**
+ * @brief   This API starts saturating stream copy traffic on the secondary
+ *          PEs in the scope of a cache or memory node, or on all secondary
+ *          PEs if none of them is in the scope of the node. Every aggressor
+ *          copies within its own shared memcopy buffer.
+ *          1. Caller       -  Test Suite, primary PE only
+ *          2. Prerequisite -  val_allocate_shared_memcpybuf, val_prepare_shared_memcpybuf
+ * @param   node_type  - MPAM_NODE_CACHE or MPAM_NODE_MEMORY
+ * @param   node_index - node the traffic contends for
+ * @param   partid     - PARTID the aggressor traffic is generated with
+ * @param   buf_size   - size of the shared memcopy buffer of each PE
+ * @return  Number of aggressor PEs started
+ */
+uint32_t val_benchmark_start_aggressors(uint32_t node_type, uint32_t node_index,
+                                        uint16_t partid, uint64_t buf_size)
+{
+
+    uint32_t pe_index;
+    uint32_t aggr_cnt = 0;
+    uint32_t scope_pe_cnt;
+    uint32_t num_pe = val_pe_get_num();
+    uint32_t my_index = val_pe_get_index_mpid(val_pe_get_mpid());
+
+    if (node_type == MPAM_NODE_CACHE)
+        scope_pe_cnt = val_topology_get_cache_pes(node_index, NULL, 0);
+    else
+        scope_pe_cnt = val_topology_get_memory_pes(node_index, NULL, 0);
+
+    scope_pe_cnt -= val_benchmark_pe_in_scope(node_type, my_index, node_index);
+
+    g_bench_contend_buf_size = buf_size;
+    g_bench_contend_flag = 1;
+    val_data_cache_ops_by_va((addr_t)&g_bench_contend_buf_size, CLEAN);
+    val_data_cache_ops_by_va((addr_t)&g_bench_contend_flag, CLEAN);
+
+    for (pe_index = 0; pe_index < num_pe; pe_index++) {
+
+        if (pe_index == my_index)
+            continue;
+
+        if (scope_pe_cnt && !val_benchmark_pe_in_scope(node_type, pe_index, node_index))
+            continue;
+
+        val_set_status(pe_index, RESULT_PENDING(0));
+        val_execute_on_pe(pe_index, (void (*)(void))val_benchmark_aggressor, partid);
+        aggr_cnt++;
+    }
+
+    return aggr_cnt;
+}
+
+/**
+ * @brief   This API stops the aggressor traffic started by
+ *          val_benchmark_start_aggressors and waits for the aggressors
+ *          to complete.
+ *          1. Caller       -  Test Suite, primary PE only
+ *          2. Prerequisite -  val_benchmark_start_aggressors
+ * @param   None
+ * @return  ACS_STATUS_PASS, or ACS_STATUS_ERR if an aggressor did not complete
+ */
+uint32_t val_benchmark_stop_aggressors(void)
+{
+
+    uint32_t pe_index;
+    uint32_t pending;
+    uint32_t num_pe = val_pe_get_num();
+    uint32_t my_index = val_pe_get_index_mpid(val_pe_get_mpid());
+    uint64_t timeout;
+
+    g_bench_contend_flag = 0;
+    val_data_cache_ops_by_va((addr_t)&g_bench_contend_flag, CLEAN);
+
+    timeout = num_pe * TIMEOUT_LARGE;
+    do {
+        pending = 0;
+        for (pe_index = 0; pe_index < num_pe; pe_index++) {
+            if (pe_index != my_index)
+                pending |= IS_RESULT_PENDING(val_get_status(pe_index));
+        }
+    } while (pending && (--timeout));
+
+    if (pending) {
+        val_print(ACS_PRINT_ERR, "\n       Stopping the aggressor PEs timed out", 0);
+        return ACS_STATUS_ERR;
+    }
+
+    return ACS_STATUS_PASS;
+}
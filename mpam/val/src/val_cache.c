@@ -165,30 +165,56 @@ uint16_t val_cache_mon_count(uint32_t node_index)
 void val_cache_configure_cpor(uint32_t node_index, uint16_t partid, uint32_t cpbm_percentage)
 {
 
+    uint16_t num_cpbm_bits;
+
+    /*
+     * Configure CPBM register to have a 1 in cpbm_percentage
+     * bits in the overall CPBM_WD bit positions
+     */
+    num_cpbm_bits = val_cache_cpbm_width(node_index) * cpbm_percentage / 100;
+    val_cache_configure_cpor_range(node_index, partid, 0, num_cpbm_bits);
+}
+
+/**
+ * @brief   This API gives a PARTID an exact set of cache portions. The bits
+ *          [first_portion, first_portion + num_portions) of the CPBM are set,
+ *          all the other bits of the CPBM_WD wide bitmap are cleared.
+ *
+ * @param   node_index    - MPAM feature page index for this MSC
+ * @param   partid        - PARTID to configure
+ * @param   first_portion - first cache portion allocated to the PARTID
+ * @param   num_portions  - number of cache portions allocated to the PARTID
+ * @return  None
+ */
+void val_cache_configure_cpor_range(uint32_t node_index, uint16_t partid,
+                                    uint16_t first_portion, uint16_t num_portions)
+{
+
     addr_t base;
-    uint16_t index;
-    uint32_t unset_bitmask;
-    uint32_t num_unset_bits;
+    uint32_t reg_index;
+    uint32_t bit_index;
+    uint32_t bitmap;
+    uint32_t last_portion;
     uint16_t num_cpbm_bits;
 
     base = val_node_hwreg_base(MPAM_NODE_CACHE, node_index);
     num_cpbm_bits = val_cache_cpbm_width(node_index);
+    last_portion = GET_MIN_VALUE((uint32_t)first_portion + num_portions, num_cpbm_bits);
 
     /* Select the PARTID to configure portion partition parameters */
     val_mmio_write(base + REG_MPAMCFG_PART_SEL, partid);
 
-    /*
-     * Configure CPBM register to have a 1 in cpbm_percentage
-     * bits in the overall CPBM_WD bit positions
-     */
-    num_cpbm_bits = num_cpbm_bits * cpbm_percentage / 100;
-    for (index = 0; index < num_cpbm_bits-31; index += 32)
-        val_mmio_write(base + REG_MPAMCFG_CPBM + index, CPOR_BITMAP_DEF_VAL);
+    /* Every 32-bit CPBM register holds 32 portions */
+    for (reg_index = 0; (reg_index * 32) < num_cpbm_bits; reg_index++) {
+        bitmap = 0;
+        for (bit_index = 0; bit_index < 32; bit_index++) {
+            if (((reg_index * 32 + bit_index) >= first_portion) &&
+                ((reg_index * 32 + bit_index) < last_portion))
+                bitmap |= (1U << bit_index);
+        }
 
-    num_unset_bits = num_cpbm_bits - index;
-    unset_bitmask = (1 << num_unset_bits) - 1;
-    if(unset_bitmask)
-        val_mmio_write(base + REG_MPAMCFG_CPBM + index, unset_bitmask);
+        val_mmio_write(base + REG_MPAMCFG_CPBM + (reg_index * 4), bitmap);
+    }
 
     val_memory_ops_issue_barrier(DSB);
     return;
@@ -219,6 +245,26 @@ void val_cache_configure_ccap(uint32_t node_index, uint16_t partid, uint8_t hard
     return;
 }
 
+/**
+ * @brief   This API returns the scope of the input cache node
+ *
+ * @param   node_index  - index into global mpam info cache table
+ * @return  CACHE_SCOPE_PRIVATE, CACHE_SCOPE_CLUSTER or CACHE_SCOPE_SYSTEM
+ */
+uint32_t val_cache_get_scope(uint32_t node_index)
+{
+
+    uint32_t pe_index;
+
+    if (g_mpam_info_table == NULL) {
+         return CACHE_SCOPE_SYSTEM;
+    }
+
+    pe_index = val_pe_get_index_mpid(val_pe_get_mpid());
+
+    return g_mpam_info_table[pe_index].cache_node[node_index].info.node_scope;
+}
+
 uint32_t val_cache_get_size(uint32_t node_index)
 {
 
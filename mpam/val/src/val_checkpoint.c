@@ -0,0 +1,139 @@
+/** @file
+ * Copyright (c) 2018, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#include "include/val_infra.h"
+#include "include/val_checkpoint.h"
+
+static VAL_CHECKPOINT_t g_checkpoint;
+static uint32_t g_checkpoint_enabled;
+
+/**
+ * @brief   Persist the checkpoint record through the PAL layer
+ *
+ * @param   None
+ * @return  None
+ */
+static void val_checkpoint_save(void)
+{
+
+    if (pal_checkpoint_write(&g_checkpoint, sizeof(VAL_CHECKPOINT_t))) {
+        val_print(ACS_PRINT_WARN, "\n       Checkpoint update failed, disabling checkpoints ", 0);
+        g_checkpoint_enabled = 0;
+    }
+}
+
+/**
+ * @brief   This API loads the checkpoint left by a previous invocation, or starts
+ *          a new one if there is none or it does not match this system.
+ *          1. Caller       - Application layer
+ *          2. Prerequisite - val_pe_create_info_table
+ *
+ * @param   None
+ * @return  Number of tests with a result restored from the checkpoint
+ */
+uint32_t val_checkpoint_init(void)
+{
+
+    uint32_t i;
+    uint32_t restored = 0;
+
+    g_checkpoint_enabled = 1;
+
+    if ((pal_checkpoint_read(&g_checkpoint, sizeof(VAL_CHECKPOINT_t)) != sizeof(VAL_CHECKPOINT_t)) ||
+        (g_checkpoint.signature != ACS_CHECKPOINT_SIGNATURE) ||
+        (g_checkpoint.revision != ACS_CHECKPOINT_REVISION) ||
+        (g_checkpoint.num_pe != val_pe_get_num())) {
+
+        for (i = 0; i < ACS_CHECKPOINT_MAX_TESTS; i++)
+            g_checkpoint.result[i] = 0;
+
+        g_checkpoint.signature = ACS_CHECKPOINT_SIGNATURE;
+        g_checkpoint.revision = ACS_CHECKPOINT_REVISION;
+        g_checkpoint.num_pe = val_pe_get_num();
+        g_checkpoint.current_test = ACS_CHECKPOINT_NO_TEST;
+        val_checkpoint_save();
+        return 0;
+    }
+
+    /* A test which started but never reported a result hung or reset the system */
+    if ((g_checkpoint.current_test < ACS_CHECKPOINT_MAX_TESTS) &&
+        (g_checkpoint.result[g_checkpoint.current_test] == 0)) {
+        val_print(ACS_PRINT_ERR, "\n Test %d did not complete in the previous run", g_checkpoint.current_test);
+        g_checkpoint.result[g_checkpoint.current_test] =
+                        RESULT_FAIL(g_checkpoint.current_test, ACS_CHECKPOINT_STATUS_HANG);
+    }
+
+    g_checkpoint.current_test = ACS_CHECKPOINT_NO_TEST;
+    val_checkpoint_save();
+
+    for (i = 0; i < ACS_CHECKPOINT_MAX_TESTS; i++) {
+        if (g_checkpoint.result[i])
+            restored++;
+    }
+
+    return restored;
+}
+
+/**
+ * @brief   Return the result recorded for a test by a previous invocation
+ *
+ * @param   test_num    unique test number
+ * @return  Status word of the completed test, 0 if it still has to be run
+ */
+uint32_t val_checkpoint_get_result(uint32_t test_num)
+{
+
+    if (!g_checkpoint_enabled || (test_num >= ACS_CHECKPOINT_MAX_TESTS))
+        return 0;
+
+    return g_checkpoint.result[test_num];
+}
+
+/**
+ * @brief   Record that a test is about to run, so that a hang in this test
+ *          is detected on the next invocation
+ *
+ * @param   test_num    unique test number
+ * @return  None
+ */
+void val_checkpoint_start_test(uint32_t test_num)
+{
+
+    if (!g_checkpoint_enabled || (test_num >= ACS_CHECKPOINT_MAX_TESTS))
+        return;
+
+    g_checkpoint.current_test = test_num;
+    val_checkpoint_save();
+}
+
+/**
+ * @brief   Record the final status of a test
+ *
+ * @param   test_num    unique test number
+ * @param   status      consolidated status word of the test
+ * @return  None
+ */
+void val_checkpoint_end_test(uint32_t test_num, uint32_t status)
+{
+
+    if (!g_checkpoint_enabled || (test_num >= ACS_CHECKPOINT_MAX_TESTS))
+        return;
+
+    g_checkpoint.result[test_num] = status;
+    g_checkpoint.current_test = ACS_CHECKPOINT_NO_TEST;
+    val_checkpoint_save();
+}
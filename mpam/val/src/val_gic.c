@@ -18,10 +18,18 @@
 #include "include/val_infra.h"
 #include "include/val_gic.h"
 #include "include/val_gic_support.h"
+#include "include/val_pe.h"
 
 
 GIC_INFO_TABLE  *g_gic_info_table;
 
+/* Native interrupt path state, see val_gic_fast_path_enable */
+static void (*g_gic_isr_table[GIC_MAX_INTID])(void);
+static uint32_t g_gic_fast_path;
+static volatile uint64_t g_gic_irq_entry_time;
+static uint64_t g_gic_fw_vbar;
+static uint64_t g_gic_vector;
+
 /**
  * @brief   This API will call PAL layer to fill in the GIC information
  *          into the g_gic_info_table pointer.
@@ -170,6 +178,9 @@ uint32_t val_gic_install_isr(uint32_t int_id, void (*isr)(void))
 
     pal_gic_install_isr(int_id, isr);
 
+    if (int_id < GIC_MAX_INTID)
+        g_gic_isr_table[int_id] = isr;
+
     if (int_id > 31) {
         /*
          * UEFI GIC code is not enabling interrupt in the Distributor.
@@ -191,10 +202,177 @@ uint32_t val_gic_install_isr(uint32_t int_id, void (*isr)(void))
  */
 uint32_t val_gic_end_of_interrupt(uint32_t int_id)
 {
+    /* The native interrupt path writes the EOI once the ISR returns */
+    if (g_gic_fast_path)
+        return 0;
+
     pal_gic_end_of_interrupt(int_id);
     return 0;
 }
 
+/**
+ * @brief   IRQ dispatcher of the native interrupt path, called from ValGicIrqEntry.
+ *          An interrupt with an ISR installed through val_gic_install_isr is
+ *          acknowledged in the CPU interface, handled and ended here, without
+ *          going through the firmware. Any other interrupt is left pending and
+ *          handed to the firmware IRQ vector, which takes it as usual.
+ * @param   None
+ * @return  0 if the interrupt was handled, else the address of the stub that
+ *          enters the firmware IRQ vector
+ */
+uint64_t val_gic_irq_dispatch(void)
+{
+
+    uint32_t int_id;
+    void (*isr)(void);
+
+    g_gic_irq_entry_time = val_measurement_get_counter();
+
+    /* Peek first, the firmware acknowledges its own interrupts */
+    int_id = GicReadIccHppir1() & GIC_INTID_MASK;
+    if ((int_id >= GIC_MAX_INTID) || (g_gic_isr_table[int_id] == NULL))
+        return g_gic_vector + GIC_VECTOR_CHAIN;
+
+    int_id = GicReadIccIar1() & GIC_INTID_MASK;
+
+    /* Nothing to do for the spurious and other special INTIDs */
+    if (int_id >= GIC_MAX_INTID)
+        return 0;
+
+    isr = g_gic_isr_table[int_id];
+    if (isr != NULL) {
+        isr();
+        GicWriteIccEoir1(int_id);
+        return 0;
+    }
+
+    /*
+     * A firmware interrupt was acknowledged after it overtook the peeked one.
+     * End it and pend it again so that it reaches the firmware vector next.
+     * Level-sensitive sources, such as the timers, are still asserted.
+     */
+    GicWriteIccEoir1(int_id);
+    if (int_id > 31)
+        val_mmio_write(val_get_gicd_base() + 0x200 + ((int_id >> 5) << 2), 1 << (int_id % 32));
+
+    return 0;
+}
+
+/**
+ * @brief   This API replaces the IRQ vector of the calling PE with the native path
+ *          of val_gic_irq_dispatch, for GICv3 and later at EL2. The firmware
+ *          vector table is saved and every other vector still branches to it, so
+ *          the firmware exception handling and its interrupts keep working.
+ *          val_gic_fast_path_disable puts the firmware vector table back.
+ *          1. Caller       -  Application layer
+ *          2. Prerequisite -  val_gic_create_info_table
+ * @param   None
+ * @return  0 if enabled, ACS_STATUS_ERR if not supported
+ */
+uint32_t val_gic_fast_path_enable(void)
+{
+
+    volatile uint32_t *insn;
+    uint64_t fw_vbar, vector, entry, offset, line_size;
+    uint32_t index;
+
+    if (g_gic_fast_path)
+        return 0;
+
+    if (val_gic_get_info(GIC_INFO_VERSION) < 3) {
+        val_print(ACS_PRINT_WARN, "\n       Native interrupt path needs GICv3 system registers", 0);
+        return ACS_STATUS_ERR;
+    }
+
+    if (((val_pe_reg_read(CurrentEL) >> 2) & 0x3) != GIC_NATIVE_PATH_EL) {
+        val_print(ACS_PRINT_WARN, "\n       Native interrupt path needs the suite to run at EL2", 0);
+        return ACS_STATUS_ERR;
+    }
+
+    /* The vectors branch straight to the firmware ones, which must be in reach */
+    fw_vbar = val_pe_reg_read(VBAR_EL2);
+    vector = (uint64_t)pal_mem_allocate_code(fw_vbar, GIC_VECTOR_SIZE);
+    if (vector == 0)
+        return ACS_STATUS_ERR;
+
+    if ((fw_vbar > vector + GIC_BRANCH_RANGE) || (vector > fw_vbar + GIC_BRANCH_RANGE)) {
+        val_print(ACS_PRINT_WARN, "\n       No memory in branch range of the firmware vectors", 0);
+        pal_mem_free_buf((void *)vector, GIC_VECTOR_SIZE);
+        return ACS_STATUS_ERR;
+    }
+
+    /* Two's complement distance, A64_B keeps the bits the branch encodes */
+    offset = fw_vbar - vector;
+    insn = (volatile uint32_t *)vector;
+    for (index = 0; index < GIC_VECTOR_ENTRIES; index++)
+        insn[index * GIC_VECTOR_ENTRY_SIZE / 4] = A64_B(offset);
+
+    /* Current EL with SP_ELx IRQ: save x0 and x1, then jump to ValGicIrqEntry */
+    insn = (volatile uint32_t *)(vector + GIC_VECTOR_IRQ);
+    entry = (uint64_t)ValGicIrqEntry;
+    insn[0] = A64_STP_X0_X1_PRE;
+    insn[1] = A64_LDR_X0_LITERAL(12);
+    insn[2] = A64_BR_X0;
+    insn[3] = A64_NOP;
+    insn[4] = (uint32_t)entry;
+    insn[5] = (uint32_t)(entry >> 32);
+
+    /* Firmware hand-off: restore x0 and x1, then take the firmware IRQ vector */
+    insn = (volatile uint32_t *)(vector + GIC_VECTOR_CHAIN);
+    insn[0] = A64_LDP_X0_X1_POST;
+    insn[1] = A64_B(offset + GIC_VECTOR_IRQ - (GIC_VECTOR_CHAIN + 4));
+
+    line_size = 4 << ((val_pe_reg_read(CTR_EL0) >> 16) & 0xf);
+    for (index = 0; index < GIC_VECTOR_SIZE; index += line_size)
+        val_data_cache_ops_by_va(vector + index, CLEAN);
+    ValGicSyncInstructions();
+
+    g_gic_fw_vbar = fw_vbar;
+    g_gic_vector = vector;
+    g_gic_fast_path = 1;
+    val_pe_reg_write(VBAR_EL2, vector);
+
+    return 0;
+}
+
+/**
+ * @brief   This API restores the firmware vector table saved by
+ *          val_gic_fast_path_enable on the calling PE and frees the native one.
+ *          1. Caller       -  Application layer
+ *          2. Prerequisite -  val_gic_fast_path_enable
+ * @param   None
+ * @return  None
+ */
+void val_gic_fast_path_disable(void)
+{
+
+    if (!g_gic_fast_path)
+        return;
+
+    val_pe_reg_write(VBAR_EL2, g_gic_fw_vbar);
+    g_gic_fast_path = 0;
+
+    pal_mem_free_buf((void *)g_gic_vector, GIC_VECTOR_SIZE);
+    g_gic_vector = 0;
+}
+
+/**
+ * @brief   This API returns the system counter value sampled when the last
+ *          interrupt was taken on the native interrupt path.
+ *          1. Caller       -  Test Suite
+ *          2. Prerequisite -  val_gic_fast_path_enable
+ * @param   None
+ * @return  CNTPCT_EL0 value at IRQ entry, 0 if the native path is not enabled
+ */
+uint64_t val_gic_get_irq_entry_time(void)
+{
+
+    if (!g_gic_fast_path)
+        return 0;
+
+    return g_gic_irq_entry_time;
+}
+
 /**
  * @brief   This function routes interrupt to specific PE.
  *          1. Caller       -  Test Suite
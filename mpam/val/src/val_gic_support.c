@@ -34,6 +34,8 @@ uint64_t val_gic_reg_read(uint32_t reg_id)
             return GicReadIchHcr();
         case ICH_MISR_EL2:
             return GicReadIchMisr();
+        case ICC_IAR1_EL1:
+            return GicReadIccIar1();
         default:
            val_report_status(val_pe_get_index_mpid(val_pe_get_mpid()), RESULT_FAIL(0, 0x78));
     }
@@ -64,6 +66,9 @@ void val_gic_reg_write(uint32_t reg_id, uint64_t write_data)
         case ICC_PMR_EL1:
             GicWriteIccPmr(write_data);
             break;
+        case ICC_EOIR1_EL1:
+            GicWriteIccEoir1(write_data);
+            break;
         default:
            val_report_status(val_pe_get_index_mpid(val_pe_get_mpid()), RESULT_FAIL(0, 0x78));
     }
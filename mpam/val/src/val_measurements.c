@@ -15,8 +15,8 @@
  * limitations under the License.
  **/
 
-#include "include/val_measurements.h"
 #include "include/pal_interface.h"
+#include "include/val_measurements.h"
 
 /**
  * @brief   Configures necessary PMU registers & starts the Cycle Counter
@@ -51,3 +51,62 @@ uint64_t val_measurement_read()
 {
     return pal_pmu_reg_read(PMCCNTR_EL0);
 }
+
+/**
+ * @brief   Read the system counter, which unlike the cycle counter
+ *          keeps a fixed frequency and is common to all PEs
+ *
+ * @param   None
+ * @return  CNTPCT_EL0 value
+ */
+uint64_t val_measurement_get_counter()
+{
+    return ArmReadCntPct();
+}
+
+/**
+ * @brief   Read the frequency of the system counter
+ *
+ * @param   None
+ * @return  CNTFRQ_EL0 value in Hz
+ */
+uint64_t val_measurement_get_counter_freq()
+{
+    return ArmReadCntFrq();
+}
+
+/**
+ * @brief   Program PMU event counter 0 with a PMU event, reset it and
+ *          enable it. The counters only count after val_measurement_start.
+ *
+ * @param   event   - PMU event number, PMU_EVENT_xxx
+ * @return  None
+ */
+void val_measurement_event_start(uint32_t event)
+{
+    pal_pmu_reg_write(PMEVTYPER0_EL0, (event & 0xFFFF) | (1ULL << PMEVTYPER_NSH_EN_BIT));
+    pal_pmu_reg_write(PMEVCNTR0_EL0, 0);
+    pal_pmu_reg_write(PMCNTENSET_EL0, (1 << PMCNTEN_P0_BIT));
+}
+
+/**
+ * @brief   Disable PMU event counter 0
+ *
+ * @param   None
+ * @return  None
+ */
+void val_measurement_event_stop()
+{
+    pal_pmu_reg_write(PMCNTENCLR_EL0, (1 << PMCNTEN_P0_BIT));
+}
+
+/**
+ * @brief   Read PMU event counter 0
+ *
+ * @param   None
+ * @return  Number of events counted since val_measurement_event_start
+ */
+uint64_t val_measurement_event_read()
+{
+    return pal_pmu_reg_read(PMEVCNTR0_EL0);
+}
@@ -362,13 +362,20 @@ uint8_t val_node_supports_mon(uint8_t node_type, uint32_t node_index)
     return ((val_mmio_read(base + REG_MPAMF_IDR) >> IDR_HAS_MSMON_SHIFT) & IDR_HAS_MSMON_MASK);
 }
 
-void val_node_generate_msmon_oflow_error(uint32_t node_index, uint16_t mon_count)
+/**
+ * @brief   Program the last MBWU monitor of a memory node one count below
+ *          overflow, with the overflow interrupt enabled. Any traffic of the
+ *          default PARTID and PMG then raises the interrupt.
+ *
+ * @param   node_index - index of the memory node
+ * @param   mon_count  - number of monitors implemented in the node
+ *
+ * @return  None
+ */
+void val_node_setup_msmon_oflow(uint32_t node_index, uint16_t mon_count)
 {
 
     addr_t base;
-    void *src_buf = 0;
-    void *dest_buf = 0;
-    uint64_t buf_size;
 
     base = val_node_hwreg_base(MPAM_NODE_MEMORY, node_index);
     err_ctrl_reg = val_mmio_read(base + REG_MPAMF_ECR);
@@ -394,6 +401,16 @@ void val_node_generate_msmon_oflow_error(uint32_t node_index, uint16_t mon_count
     val_mmio_write(base + REG_MSMON_MBWU, ((0 << MBWU_CAPTURE_NRDY_SHIFT) | MBWU_VALUE_MAX));
 
     val_memory_ops_issue_barrier(DSB);
+}
+
+void val_node_generate_msmon_oflow_error(uint32_t node_index, uint16_t mon_count)
+{
+
+    void *src_buf = 0;
+    void *dest_buf = 0;
+    uint64_t buf_size;
+
+    val_node_setup_msmon_oflow(node_index, mon_count);
 
     /* Create two MB buffers sufficient to cretae overflow for this memory channel */
     buf_size = TWO_MB;
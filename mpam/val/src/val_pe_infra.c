@@ -26,6 +26,9 @@ PE_INFO_TABLE *g_pe_info_table;
 /* Global structure to pass and retrieve arguments for the SMC call */
 ARM_SMC_ARGS g_smc_args;
 
+/* Set when the secondary PEs wait in val_pe_park_loop for payloads */
+static uint32_t g_pe_parked;
+
 /**
  * @brief   This API will call PAL layer to fill in the PE information
  *          into the g_pe_info_table pointer.
@@ -170,9 +173,174 @@ void val_test_entry(void)
     pal_pe_call_smc(&smc_args);
 }
 
+/**
+ * @brief   Write the mailbox of a parked PE to the point of coherency, so that
+ *          it is observed by a PE running with its caches off
+ * @param   index   - Index of the PE owning the mailbox
+ * @param   mailbox - New mailbox state
+ * @return  None
+ */
+static void val_pe_set_mailbox(uint32_t index, uint32_t mailbox)
+{
+
+    volatile VAL_SHARED_MEM_t *mem;
+
+    mem = (VAL_SHARED_MEM_t *)pal_mem_get_shared_addr();
+    mem = mem + index;
+    mem->mailbox = mailbox;
+
+    val_data_cache_ops_by_va((addr_t)&mem->mailbox, CLEAN_AND_INVALIDATE);
+}
+
+/**
+ * @brief   Read the mailbox of a parked PE
+ * @param   index - Index of the PE owning the mailbox
+ * @return  Mailbox state
+ */
+static uint32_t val_pe_get_mailbox(uint32_t index)
+{
+
+    volatile VAL_SHARED_MEM_t *mem;
+
+    mem = (VAL_SHARED_MEM_t *)pal_mem_get_shared_addr();
+    mem = mem + index;
+
+    val_data_cache_ops_by_va((addr_t)&mem->mailbox, INVALIDATE);
+
+    return mem->mailbox;
+}
+
+/**
+ * @brief   Wait for a parked PE to finish its current payload
+ * @param   index - Index of the parked PE
+ * @return  0 if the PE is idle, 1 on timeout
+ */
+static uint32_t val_pe_wait_for_idle(uint32_t index)
+{
+
+    uint32_t timeout = TIMEOUT_LARGE;
+
+    while ((val_pe_get_mailbox(index) != PE_MAILBOX_IDLE) && --timeout);
+
+    return (timeout == 0);
+}
+
+/**
+ * @brief   Payload which keeps a secondary PE powered on between tests.
+ *          The PE waits for events and runs every payload posted to its
+ *          mailbox, until it is asked to exit and return to val_test_entry
+ *          which switches it off.
+ * @param   None
+ * @return  None
+ */
+static void val_pe_park_loop(void)
+{
+
+    uint32_t index = val_pe_get_index_mpid(val_pe_get_mpid());
+    uint32_t mailbox;
+    uint64_t test_arg;
+    void (*vector)(uint64_t args);
+
+    val_pe_set_mailbox(index, PE_MAILBOX_IDLE);
+
+    while (1) {
+        mailbox = val_pe_get_mailbox(index);
+
+        if (mailbox == PE_MAILBOX_EXIT)
+            break;
+
+        /* SEV sets the event register, so a dispatch after the read is not lost */
+        if (mailbox != PE_MAILBOX_DISPATCH) {
+            arm64_wait_for_event();
+            continue;
+        }
+
+        val_pe_set_mailbox(index, PE_MAILBOX_BUSY);
+        val_get_test_data(index, (uint64_t *)&vector, &test_arg);
+        vector(test_arg);
+        val_pe_set_mailbox(index, PE_MAILBOX_IDLE);
+    }
+}
+
+/**
+ * @brief   This API powers on all secondary PEs once and parks them in a
+ *          mailbox loop, so that val_execute_on_pe dispatches payloads
+ *          without a PSCI CPU_ON and CPU_OFF for every payload.
+ *          1. Caller       -  Application layer
+ *          2. Prerequisite -  val_pe_create_info_table, val_allocate_shared_mem
+ * @param   None
+ * @return  ACS_STATUS_PASS if all secondaries are parked, else ACS_STATUS_FAIL
+ */
+uint32_t val_pe_park_secondaries(void)
+{
+
+    uint32_t index;
+    uint32_t my_index = val_pe_get_index_mpid(val_pe_get_mpid());
+    uint32_t num_pe = val_pe_get_num();
+
+    for (index = 0; index < num_pe; index++) {
+        if (index != my_index) {
+            val_pe_set_mailbox(index, PE_MAILBOX_OFF);
+            val_execute_on_pe(index, val_pe_park_loop, 0);
+        }
+    }
+
+    for (index = 0; index < num_pe; index++) {
+        if ((index != my_index) && val_pe_wait_for_idle(index)) {
+            val_print(ACS_PRINT_ERR, "\n       Secondary PE %d failed to park ", index);
+            g_pe_parked = 1;
+            val_pe_release_secondaries();
+            return ACS_STATUS_FAIL;
+        }
+    }
+
+    g_pe_parked = 1;
+    val_data_cache_ops_by_va((addr_t)&g_pe_parked, CLEAN_AND_INVALIDATE);
+
+    return ACS_STATUS_PASS;
+}
+
+/**
+ * @brief   This API makes all parked secondary PEs leave the mailbox loop
+ *          and switch off with PSCI CPU_OFF.
+ *          1. Caller       -  Application layer
+ *          2. Prerequisite -  val_pe_park_secondaries
+ * @param   None
+ * @return  None
+ */
+void val_pe_release_secondaries(void)
+{
+
+    uint32_t index;
+    uint32_t my_index = val_pe_get_index_mpid(val_pe_get_mpid());
+    uint32_t num_pe = val_pe_get_num();
+
+    if (!g_pe_parked)
+        return;
+
+    for (index = 0; index < num_pe; index++) {
+        if (index == my_index)
+            continue;
+
+        if (val_pe_get_mailbox(index) == PE_MAILBOX_OFF)
+            continue;
+
+        if (val_pe_wait_for_idle(index))
+            val_print(ACS_PRINT_WARN, "\n       Secondary PE %d still busy at release ", index);
+
+        val_pe_set_mailbox(index, PE_MAILBOX_EXIT);
+    }
+
+    arm64_send_event();
+
+    g_pe_parked = 0;
+    val_data_cache_ops_by_va((addr_t)&g_pe_parked, CLEAN_AND_INVALIDATE);
+}
+
 /**
  *  @brief  This API initiates the execution of a test on a secondary PE.
- *          Uses PSCI_CPU_ON to wake a secondary PE
+ *          Uses PSCI_CPU_ON to wake a secondary PE, or the mailbox of the
+ *          PE if the secondaries are parked
  *          1. Caller       -  Test Suite
  *          2. Prerequisite -  val_create_peinfo_table
  * @param   index - Index of the PE to be woken up
@@ -190,6 +358,19 @@ void val_execute_on_pe(uint32_t index, void (*payload)(void), uint64_t test_inpu
         return;
     }
 
+    if (g_pe_parked) {
+        if (val_pe_wait_for_idle(index)) {
+            val_print(ACS_PRINT_ERR, "       Parked PE %d busy with previous payload \n", index);
+            val_set_status(index, RESULT_FAIL(0, 0x130));
+            return;
+        }
+
+        val_set_test_data(index, (uint64_t)payload, test_input);
+        val_pe_set_mailbox(index, PE_MAILBOX_DISPATCH);
+        arm64_send_event();
+        return;
+    }
+
     do {
         g_smc_args.Arg0 = ARM_SMC_ID_PSCI_CPU_ON_AARCH64;
 
@@ -286,14 +467,5 @@ void val_pe_default_esr(uint64_t interrupt_type, void *context)
 void val_pe_cache_clean_range(uint64_t start_addr, uint64_t length)
 {
 
-    uint64_t aligned_addr, end_addr, line_length;
-
-    line_length = 2 << ((val_pe_reg_read(CTR_EL0) >> 16) & 0xf);
-    aligned_addr = start_addr - (start_addr & (line_length-1));
-    end_addr = start_addr + length;
-
-    while (aligned_addr < end_addr) {
-        val_data_cache_ops_by_va(aligned_addr, CLEAN);
-        aligned_addr += line_length;
-    }
+    val_data_cache_ops_by_range(start_addr, length, CLEAN);
 }
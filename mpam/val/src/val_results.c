@@ -0,0 +1,176 @@
+/** @file
+ * Copyright (c) 2018, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#include "include/val_infra.h"
+#include "include/val_results.h"
+#include "include/val_samples.h"
+
+static VAL_RESULTS_SAMPLE_t g_results_sample[ACS_RESULTS_MAX_SAMPLES];
+static uint32_t g_results_sample_cnt;
+static uint64_t g_results_start_time;
+static uint32_t g_results_enabled;
+
+static char8_t *g_results_stat_name[] = {"", "min", "mean", "p50", "p90", "p99", "max"};
+
+/**
+ * @brief   This API enables the structured results output. One JSON object is
+ *          written per line for every test run, for consumption by tools.
+ *          1. Caller       - Application layer
+ *          2. Prerequisite - None
+ *
+ * @param   None
+ * @return  None
+ */
+void val_results_init(void)
+{
+    g_results_enabled = 1;
+    g_results_sample_cnt = 0;
+}
+
+/**
+ * @brief   Mark the start of a test, clear the samples of the previous test
+ *
+ * @param   test_num    unique test number
+ * @return  None
+ */
+void val_results_start_test(uint32_t test_num)
+{
+
+    if (!g_results_enabled)
+        return;
+
+    g_results_sample_cnt = 0;
+    g_results_start_time = val_measurement_get_counter();
+}
+
+/**
+ * @brief   This API records a measurement taken by the test in progress.
+ *          Samples beyond ACS_RESULTS_MAX_SAMPLES are dropped from the
+ *          results record, every sample is kept by the raw sample recorder.
+ *          1. Caller       - Test Suite, primary PE only
+ *          2. Prerequisite - val_initialize_test
+ *
+ * @param   node_type   MPAM_NODE_CACHE, MPAM_NODE_MEMORY or ACS_RESULTS_NODE_PE
+ * @param   node_index  index of the node measured, ACS_RESULTS_ALL_NODES if all
+ * @param   scenario    index of the test scenario
+ * @param   partid      PARTID the traffic was generated with
+ * @param   value       measured value
+ * @param   unit        unit of the value in the sample file, ACS_SAMPLE_UNIT_*
+ * @return  None
+ */
+void val_results_add_sample(uint32_t node_type, uint32_t node_index, uint32_t scenario,
+                            uint32_t partid, uint64_t value, uint32_t unit)
+{
+    val_samples_record(node_type, node_index, scenario, val_pe_get_index_mpid(val_pe_get_mpid()),
+                       partid, value, unit);
+    val_results_add_stat(node_type, node_index, scenario, partid, ACS_RESULTS_STAT_NONE, value);
+}
+
+/**
+ * @brief   This API records one statistic of a distribution measured by the
+ *          test in progress, e.g. the p99 of a benchmark scenario.
+ *          1. Caller       - Test Suite, primary PE only
+ *          2. Prerequisite - val_initialize_test
+ *
+ * @param   node_type   MPAM_NODE_CACHE, MPAM_NODE_MEMORY or ACS_RESULTS_NODE_PE
+ * @param   node_index  index of the node measured, ACS_RESULTS_ALL_NODES if all
+ * @param   scenario    index of the test scenario
+ * @param   partid      PARTID the traffic was generated with
+ * @param   stat        ACS_RESULTS_STAT_e statistic held by value
+ * @param   value       measured value, in PMU cycles for latencies
+ * @return  None
+ */
+void val_results_add_stat(uint32_t node_type, uint32_t node_index, uint32_t scenario,
+                          uint32_t partid, uint32_t stat, uint64_t value)
+{
+
+    VAL_RESULTS_SAMPLE_t *sample;
+
+    if (!g_results_enabled || (g_results_sample_cnt >= ACS_RESULTS_MAX_SAMPLES))
+        return;
+
+    sample = &g_results_sample[g_results_sample_cnt++];
+    sample->node_type = node_type;
+    sample->node_index = node_index;
+    sample->scenario = scenario;
+    sample->partid = partid;
+    sample->stat = stat;
+    sample->value = value;
+}
+
+/**
+ * @brief   Write the record of a completed test
+ *
+ * @param   test_num    unique test number
+ * @param   status      consolidated status word of the test
+ * @return  None
+ */
+void val_results_end_test(uint32_t test_num, uint32_t status)
+{
+
+    uint32_t i;
+    VAL_RESULTS_SAMPLE_t *sample;
+    char8_t *node_name;
+    uint64_t end_time;
+
+    if (!g_results_enabled)
+        return;
+
+    end_time = val_measurement_get_counter();
+
+    pal_results_print("{\"test\":%d", test_num);
+
+    if (IS_TEST_PASS(status))
+        pal_results_print(",\"result\":\"PASS\"", 0);
+    else if (IS_TEST_FAIL(status))
+        pal_results_print(",\"result\":\"FAIL\"", 0);
+    else if (IS_TEST_SKIP(status))
+        pal_results_print(",\"result\":\"SKIP\"", 0);
+    else
+        pal_results_print(",\"result\":\"UNKNOWN\"", 0);
+
+    pal_results_print(",\"status\":%d", status & 0xFFFF);
+    pal_results_print(",\"start\":%ld", g_results_start_time);
+    pal_results_print(",\"ticks\":%ld", end_time - g_results_start_time);
+    pal_results_print(",\"freq\":%ld", val_measurement_get_counter_freq());
+    pal_results_print(",\"samples\":[", 0);
+
+    for (i = 0; i < g_results_sample_cnt; i++) {
+        sample = &g_results_sample[i];
+
+        if (sample->node_type == ACS_RESULTS_NODE_PE)
+            node_name = "pe";
+        else if (sample->node_type == MPAM_NODE_CACHE)
+            node_name = "cache";
+        else
+            node_name = "memory";
+
+        pal_results_print((i == 0) ? "{\"node_type\":\"%a\"" : ",{\"node_type\":\"%a\"",
+                          (uint64_t)node_name);
+        if (sample->node_index != ACS_RESULTS_ALL_NODES)
+            pal_results_print(",\"node\":%d", sample->node_index);
+        pal_results_print(",\"scenario\":%d", sample->scenario);
+        pal_results_print(",\"partid\":%d", sample->partid);
+        if (sample->stat != ACS_RESULTS_STAT_NONE)
+            pal_results_print(",\"stat\":\"%a\"", (uint64_t)g_results_stat_name[sample->stat]);
+        pal_results_print(",\"value\":%ld}", sample->value);
+    }
+
+    pal_results_print("]}\n", 0);
+    pal_results_flush();
+    g_results_sample_cnt = 0;
+}
@@ -0,0 +1,170 @@
+/** @file
+ * Copyright (c) 2018, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#include "include/val_infra.h"
+#include "include/val_results.h"
+#include "include/val_samples.h"
+
+static VAL_SAMPLE_t *g_samples;
+static uint32_t g_samples_cnt;
+static uint32_t g_samples_dropped;
+static uint32_t g_samples_test_num;
+
+/**
+ * @brief   This API enables the raw sample recorder. The sample buffer is
+ *          allocated once here, so that recording a sample in a measured
+ *          loop is a plain store.
+ *          1. Caller       - Application layer
+ *          2. Prerequisite - val_pe_create_info_table
+ *
+ * @param   None
+ * @return  ACS_STATUS_PASS, or ACS_STATUS_ERR if the buffer can not be allocated
+ */
+uint32_t val_samples_init(void)
+{
+
+    g_samples = (VAL_SAMPLE_t *)val_allocate_buf(ACS_SAMPLES_MAX * sizeof(VAL_SAMPLE_t));
+    if (g_samples == NULL)
+        return ACS_STATUS_ERR;
+
+    g_samples_cnt = 0;
+    g_samples_dropped = 0;
+
+    return ACS_STATUS_PASS;
+}
+
+/**
+ * @brief   Mark the start of a test, its samples are tagged with test_num
+ *
+ * @param   test_num    unique test number
+ * @return  None
+ */
+void val_samples_start_test(uint32_t test_num)
+{
+    g_samples_test_num = test_num;
+}
+
+/**
+ * @brief   This API records one timing sample into the sample buffer
+ *          1. Caller       - Test Suite, primary PE only
+ *          2. Prerequisite - val_initialize_test
+ *
+ * @param   node_type   MPAM_NODE_CACHE, MPAM_NODE_MEMORY or ACS_RESULTS_NODE_PE
+ * @param   node_index  index of the node measured, ACS_RESULTS_ALL_NODES if all
+ * @param   scenario    index of the test scenario
+ * @param   pe_index    index of the PE the sample was measured on
+ * @param   partid      PARTID the traffic was generated with
+ * @param   value       measured value
+ * @param   unit        unit of the value, ACS_SAMPLE_UNIT_*
+ * @return  None
+ */
+void val_samples_record(uint32_t node_type, uint32_t node_index, uint32_t scenario,
+                        uint32_t pe_index, uint32_t partid, uint64_t value, uint32_t unit)
+{
+
+    VAL_SAMPLE_t *sample;
+
+    if (g_samples == NULL)
+        return;
+
+    if (g_samples_cnt >= ACS_SAMPLES_MAX) {
+        g_samples_dropped++;
+        return;
+    }
+
+    sample = &g_samples[g_samples_cnt++];
+    sample->test_num = g_samples_test_num;
+    sample->scenario = scenario;
+    sample->pe_index = pe_index;
+    sample->partid = partid;
+    sample->node_type = node_type;
+    sample->node_index = node_index;
+    sample->unit = unit;
+    sample->reserved[0] = 0;
+    sample->reserved[1] = 0;
+    sample->value = value;
+    sample->counter = val_measurement_get_counter();
+}
+
+/**
+ * @brief   This API records an array of samples of one scenario measured
+ *          on the current PE, in the order they were taken
+ *          1. Caller       - Test Suite, primary PE only
+ *          2. Prerequisite - val_initialize_test
+ *
+ * @param   node_type   MPAM_NODE_CACHE, MPAM_NODE_MEMORY or ACS_RESULTS_NODE_PE
+ * @param   node_index  index of the node measured, ACS_RESULTS_ALL_NODES if all
+ * @param   scenario    index of the test scenario
+ * @param   partid      PARTID the traffic was generated with
+ * @param   values      array of measured values
+ * @param   count       number of values in the array
+ * @param   unit        unit of the values, ACS_SAMPLE_UNIT_*
+ * @return  None
+ */
+void val_samples_record_array(uint32_t node_type, uint32_t node_index, uint32_t scenario,
+                              uint32_t partid, uint64_t *values, uint32_t count, uint32_t unit)
+{
+
+    uint32_t i;
+    uint32_t pe_index;
+
+    if (g_samples == NULL)
+        return;
+
+    pe_index = val_pe_get_index_mpid(val_pe_get_mpid());
+
+    for (i = 0; i < count; i++)
+        val_samples_record(node_type, node_index, scenario, pe_index, partid, values[i], unit);
+}
+
+/**
+ * @brief   This API writes the header and all the recorded samples to the
+ *          sample file and releases the sample buffer
+ *          1. Caller       - Application layer, at the end of the run
+ *          2. Prerequisite - val_samples_init
+ *
+ * @param   None
+ * @return  None
+ */
+void val_samples_flush(void)
+{
+
+    VAL_SAMPLES_HEADER_t header;
+
+    if (g_samples == NULL)
+        return;
+
+    header.signature = ACS_SAMPLES_SIGNATURE;
+    header.revision = ACS_SAMPLES_REVISION;
+    header.header_size = sizeof(VAL_SAMPLES_HEADER_t);
+    header.sample_size = sizeof(VAL_SAMPLE_t);
+    header.num_pe = val_pe_get_num();
+    header.sample_cnt = g_samples_cnt;
+    header.dropped_cnt = g_samples_dropped;
+    header.reserved = 0;
+    header.counter_freq = val_measurement_get_counter_freq();
+
+    if (g_samples_dropped)
+        val_print(ACS_PRINT_WARN, "\n Sample buffer full, %d samples dropped", g_samples_dropped);
+
+    if (pal_samples_write(&header, sizeof(VAL_SAMPLES_HEADER_t)) ||
+        pal_samples_write(g_samples, g_samples_cnt * sizeof(VAL_SAMPLE_t)))
+        val_print(ACS_PRINT_ERR, "\n Writing the sample file failed", 0);
+
+    val_free_buf(g_samples, ACS_SAMPLES_MAX * sizeof(VAL_SAMPLE_t));
+    g_samples = NULL;
+}
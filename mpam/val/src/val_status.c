@@ -73,6 +73,33 @@ void val_set_status(uint32_t index, uint32_t status)
     val_data_cache_ops_by_va((addr_t)&mem->status, CLEAN_AND_INVALIDATE);
 }
 
+/**
+ * @brief   Record the same state and status for the first num_pe PEs, with
+ *          the maintenance of all entries merged into one pass
+ *          1. Caller       - VAL, primary PE only, as the maintenance goes
+ *                            through the shared val_data_cache_ops_batch_add queue
+ *          2. Prerequisite - val_allocate_shared_mem
+ * @param   num_pe  number of PEs whose status is set.
+ * @param   status  32-bit value concatenated from state, level, error value
+ *
+ * @return  none
+ */
+void val_set_status_all(uint32_t num_pe, uint32_t status)
+{
+    uint32_t index;
+    volatile VAL_SHARED_MEM_t *mem;
+
+    mem = (VAL_SHARED_MEM_t *) pal_mem_get_shared_addr();
+
+    for (index = 0; index < num_pe; index++) {
+        mem[index].status = status;
+        val_data_cache_ops_batch_add((addr_t)&mem[index].status, sizeof(uint32_t),
+                                     CLEAN_AND_INVALIDATE);
+    }
+
+    val_data_cache_ops_batch_flush();
+}
+
 /**
  * @brief   Return the state and status for the  input PE index
  *          1. Caller       - Test Suite
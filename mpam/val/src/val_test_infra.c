@@ -17,7 +17,13 @@
 
 #include "include/val_infra.h"
 #include "include/val_pe.h"
+#include "include/val_checkpoint.h"
+#include "include/val_results.h"
+#include "include/val_samples.h"
 
+/* Test restored from the checkpoint and its recorded result */
+static uint32_t g_restored_test;
+static uint32_t g_restored_status;
 
 /**
  * @brief  This API calls PAL layer to print a formatted string
@@ -98,12 +104,14 @@ void val_mmio_write(addr_t addr, uint32_t data)
  * @param   desc     brief description of the test
  * @param   num_pe   the number of PE to execute this test on.
  *
- * @return  Skip - if the user has overridden to skip the test.
+ * @return  Skip - if the user has overridden to skip the test, or the test
+ *                 has already completed in a previous checkpointed run.
  */
 uint32_t val_initialize_test(uint32_t test_num, char8_t *desc, uint32_t num_pe)
 {
 
     uint32_t i;
+    uint32_t status;
     uint32_t index = val_pe_get_index_mpid(val_pe_get_mpid());
 
     /*Always print this */
@@ -111,11 +119,12 @@ uint32_t val_initialize_test(uint32_t test_num, char8_t *desc, uint32_t num_pe)
     val_print(ACS_PRINT_TEST, desc, 0);
     val_report_status(0, ACS_TEST_START(test_num));
     val_pe_initialize_default_exception_handler(val_pe_default_esr);
+    val_results_start_test(test_num);
+    val_samples_start_test(test_num);
 
     g_acs_tests_total++;
 
-    for (i = 0; i < num_pe; i++)
-        val_set_status(i, RESULT_PENDING(test_num));
+    val_set_status_all(num_pe, RESULT_PENDING(test_num));
 
     for (i=0 ; i<MAX_TEST_SKIP_NUM ; i++) {
         if (g_skip_test_num[i] == test_num) {
@@ -125,6 +134,19 @@ uint32_t val_initialize_test(uint32_t test_num, char8_t *desc, uint32_t num_pe)
         }
      }
 
+    /* Do not run the test again if a previous invocation has completed it */
+    status = val_checkpoint_get_result(test_num);
+    if (status) {
+        val_print(ACS_PRINT_TEST, "\n       RESUMED - Result from checkpoint  ", 0);
+        for (i = 0; i < num_pe; i++)
+            val_set_status(i, status);
+        g_restored_test = test_num;
+        g_restored_status = status;
+        return ACS_STATUS_SKIP;
+    }
+
+    val_checkpoint_start_test(test_num);
+
      return ACS_STATUS_PASS;
 }
 
@@ -265,8 +287,7 @@ void val_set_test_data(uint32_t index, uint64_t addr, uint64_t test_data)
     mem->data0 = addr;
     mem->data1 = test_data;
 
-    val_data_cache_ops_by_va((addr_t)&mem->data0, CLEAN_AND_INVALIDATE);
-    val_data_cache_ops_by_va((addr_t)&mem->data1, CLEAN_AND_INVALIDATE);
+    val_data_cache_ops_by_range((addr_t)&mem->data0, 2 * sizeof(uint64_t), CLEAN_AND_INVALIDATE);
 }
 
 /**
@@ -293,8 +314,7 @@ void val_get_test_data(uint32_t index, uint64_t *data0, uint64_t *data1)
     mem = (VAL_SHARED_MEM_t *) pal_mem_get_shared_addr();
     mem = mem + index;
 
-    val_data_cache_ops_by_va((addr_t)&mem->data0, INVALIDATE);
-    val_data_cache_ops_by_va((addr_t)&mem->data1, INVALIDATE);
+    val_data_cache_ops_by_range((addr_t)&mem->data0, 2 * sizeof(uint64_t), INVALIDATE);
 
     *data0 = mem->data0;
     *data1 = mem->data1;
@@ -321,6 +341,123 @@ uint64_t val_get_shared_memcpybuf(uint32_t pe_index)
     return (uint64_t)(smem_memcpy_buf[pe_index]);
 }
 
+/**
+ * @brief   Zero a buffer with DC ZVA, so that its first use in a measurement
+ *          does not also pay for the first write to every line and page
+ *
+ * @param   buf     - buffer address
+ * @param   size    - buffer size in bytes
+ *
+ * @result  None
+ */
+void val_mem_prepare_buf(void *buf, uint64_t size)
+{
+
+    if (buf == NULL)
+        return;
+
+    arm64_zero_range((uint64_t)buf, size);
+}
+
+/* Per PE completion flags of val_prepare_shared_memcpybuf, one cache line each */
+static volatile uint8_t *g_prepare_done;
+static uint64_t g_prepare_stride;
+
+/**
+ * @brief   Payload run on every PE to prepare its own shared memcopy buffer
+ *
+ * @param   buf_size    - size of the shared buffer of each PE
+ *
+ * @result  None
+ */
+static void val_mem_prepare_payload(uint64_t buf_size)
+{
+
+    uint32_t pe_index = val_pe_get_index_mpid(val_pe_get_mpid());
+    volatile uint8_t *done;
+
+    val_mem_prepare_buf((void *)val_get_shared_memcpybuf(pe_index), buf_size);
+
+    val_data_cache_ops_by_va((addr_t)&g_prepare_done, INVALIDATE);
+    val_data_cache_ops_by_va((addr_t)&g_prepare_stride, INVALIDATE);
+
+    done = g_prepare_done + (pe_index * g_prepare_stride);
+    *done = 1;
+    val_data_cache_ops_by_va((addr_t)done, CLEAN_AND_INVALIDATE);
+}
+
+/**
+ * @brief   Prepare the shared memcopy buffers of num_pe PEs in parallel,
+ *          each PE zeroing its own buffer. Completion is tracked with flags
+ *          of its own, the PE status is left untouched.
+ *          1. Caller       - Test Suite, primary PE only
+ *          2. Prerequisite - val_allocate_shared_memcpybuf
+ *
+ * @param   num_pe      - number of PEs holding shared buffers
+ * @param   buf_size    - size of shared buffer each PE is holding
+ *
+ * @result  ACS_STATUS_PASS, or ACS_STATUS_ERR if a PE did not complete
+ */
+uint32_t val_prepare_shared_memcpybuf(uint32_t num_pe, uint64_t buf_size)
+{
+
+    uint32_t pe_index;
+    uint32_t my_index = val_pe_get_index_mpid(val_pe_get_mpid());
+    uint32_t pending;
+    uint64_t timeout;
+    uint64_t done_size;
+    volatile uint8_t *done;
+
+    g_prepare_stride = 4 << ((val_pe_reg_read(CTR_EL0) >> 16) & 0xf);
+    done_size = num_pe * g_prepare_stride;
+
+    g_prepare_done = (volatile uint8_t *)val_allocate_buf(done_size);
+    if (g_prepare_done == NULL) {
+        val_print(ACS_PRINT_ERR, "\n       Mem allocation for prepare flags failed", 0);
+        return ACS_STATUS_ERR;
+    }
+
+    for (pe_index = 0; pe_index < num_pe; pe_index++) {
+        done = g_prepare_done + (pe_index * g_prepare_stride);
+        *done = 0;
+        val_data_cache_ops_by_va((addr_t)done, CLEAN_AND_INVALIDATE);
+    }
+
+    val_data_cache_ops_by_va((addr_t)&g_prepare_done, CLEAN);
+    val_data_cache_ops_by_va((addr_t)&g_prepare_stride, CLEAN);
+
+    for (pe_index = 0; pe_index < num_pe; pe_index++) {
+        if (pe_index != my_index)
+            val_execute_on_pe(pe_index, (void (*)(void))val_mem_prepare_payload, buf_size);
+    }
+
+    val_mem_prepare_buf((void *)val_get_shared_memcpybuf(my_index), buf_size);
+
+    timeout = num_pe * TIMEOUT_LARGE;
+    do {
+        pending = 0;
+        for (pe_index = 0; pe_index < num_pe; pe_index++) {
+            if (pe_index == my_index)
+                continue;
+
+            done = g_prepare_done + (pe_index * g_prepare_stride);
+            val_data_cache_ops_by_va((addr_t)done, INVALIDATE);
+            pending |= !(*done);
+        }
+    } while (pending && (--timeout));
+
+    /* A PE that timed out may still write its flag, keep the flags allocated then */
+    if (pending) {
+        val_print(ACS_PRINT_ERR, "\n       Preparing the shared memcopy buffers timed out", 0);
+        return ACS_STATUS_ERR;
+    }
+
+    val_free_buf((void *)g_prepare_done, done_size);
+    g_prepare_done = NULL;
+
+    return ACS_STATUS_PASS;
+}
+
 /**
  * @brief   Free the shared memcopy buffers for num_pe PEs
  *
@@ -346,10 +483,14 @@ void val_mem_free_shared_memcpybuf(uint32_t num_pe, uint64_t buf_size)
 uint64_t *val_get_shared_latencybuf(uint32_t scenario_index, uint32_t node_index)
 {
 
-    uint64_t **smem_latency_buf = 0;
+    uint64_t smem_latency_buf;
 
-    smem_latency_buf = (uint64_t **)pal_mem_get_shared_latencybuf_addr();
-    return (uint64_t *)(smem_latency_buf[node_index]+scenario_index);
+    smem_latency_buf = pal_mem_get_shared_latencybuf_addr();
+    if (smem_latency_buf == 0)
+        return NULL;
+
+    return (uint64_t *)(smem_latency_buf + (node_index * pal_mem_get_shared_latencybuf_stride()))
+                        + scenario_index;
 }
 
 /**
@@ -449,7 +590,22 @@ uint32_t val_check_for_error(uint32_t test_num, uint32_t num_pe)
     uint32_t i;
     uint32_t status = 0;
     uint32_t error_flag = 0;
+    uint32_t restored = 0;
     uint32_t my_index = val_pe_get_index_mpid(val_pe_get_mpid());
+    volatile VAL_SHARED_MEM_t *mem;
+
+    /* The entry function may have seeded a status over the restored result.
+     * The result is already recorded, so the end of test hooks are skipped.
+     */
+    if (g_restored_test == test_num) {
+        g_restored_test = 0;
+        restored = 1;
+        for (i = 0; i < num_pe; i++)
+            val_set_status(i, g_restored_status);
+        /* The main PE is not always among the first num_pe entries */
+        if (my_index >= num_pe)
+            val_set_status(my_index, g_restored_status);
+    }
 
     /*
      * This special case is needed when the Main PE is not the first
@@ -458,6 +614,12 @@ uint32_t val_check_for_error(uint32_t test_num, uint32_t num_pe)
     if (num_pe == 1) {
         status = val_get_status(my_index);
         val_report_status(my_index, status);
+        if (!restored) {
+            val_results_end_test(test_num, status);
+            if (!IS_TEST_SKIP(status))
+                val_checkpoint_end_test(test_num, status);
+        }
+
         if (IS_TEST_PASS(status)) {
             g_acs_tests_pass++;
             return ACS_STATUS_PASS;
@@ -470,8 +632,19 @@ uint32_t val_check_for_error(uint32_t test_num, uint32_t num_pe)
         return ACS_STATUS_FAIL;
     }
 
+    /* A secondary PE that overflowed its stack has corrupted its neighbour's */
+    i = pal_pe_check_stack_guard();
+    if (i != 0xFFFFFFFF) {
+        val_print(ACS_PRINT_ERR, "\n       Stack overflow detected on PE index %d", i);
+        val_set_status(i, RESULT_FAIL(test_num, 0x140));
+    }
+
+    /* Collect the status of all PEs with a single maintenance pass */
+    mem = (VAL_SHARED_MEM_t *)pal_mem_get_shared_addr();
+    val_data_cache_ops_by_range((addr_t)mem, num_pe * sizeof(VAL_SHARED_MEM_t), INVALIDATE);
+
     for (i = 0; i < num_pe; i++) {
-        status = val_get_status(i);
+        status = mem[i].status;
         //val_print(ACS_PRINT_ERR, "Status %4x \n", status);
         if (IS_TEST_FAIL_SKIP(status)) {
             val_report_status(i, status);
@@ -483,6 +656,12 @@ uint32_t val_check_for_error(uint32_t test_num, uint32_t num_pe)
     if (!error_flag)
         val_report_status(my_index, status);
 
+    if (!restored) {
+        val_results_end_test(test_num, status);
+        if (!IS_TEST_SKIP(status))
+            val_checkpoint_end_test(test_num, status);
+    }
+
     if (IS_TEST_PASS(status)) {
         g_acs_tests_pass++;
         return ACS_STATUS_PASS;
@@ -505,6 +684,120 @@ void val_data_cache_ops_by_va(addr_t addr, uint32_t type)
 
 }
 
+/**
+ * @brief   Perform a cache maintenance operation on every data cache line
+ *          of an address range, with a single barrier for the whole range
+ *
+ * @param   addr    - start address of the range
+ * @param   size    - size of the range in bytes
+ * @param   type    - CLEAN, INVALIDATE or CLEAN_AND_INVALIDATE
+ *
+ * @return  None
+ */
+void val_data_cache_ops_by_range(addr_t addr, uint64_t size, uint32_t type)
+{
+    pal_pe_data_cache_ops_by_range(addr, size, type);
+
+}
+
+#define CACHE_OPS_BATCH_MAX 8
+
+typedef struct {
+    addr_t      start;
+    addr_t      end;
+    uint32_t    type;
+} VAL_CACHE_OPS_RANGE_t;
+
+/* A single queue without a lock, owned by the primary PE. Payloads running
+ * on secondary PEs must use val_data_cache_ops_by_range directly.
+ */
+static VAL_CACHE_OPS_RANGE_t g_cache_ops_batch[CACHE_OPS_BATCH_MAX];
+static uint32_t g_cache_ops_batch_cnt;
+
+/**
+ * @brief   Queue a cache maintenance operation on an address range. Requests
+ *          of the same type which overlap or touch the same cache line are
+ *          merged, including ranges joined only through the new request, and
+ *          the queue is issued by val_data_cache_ops_batch_flush. A request
+ *          overlapping a queued range of another type flushes the queue first,
+ *          so that operations on a line keep their order.
+ *          1. Caller       - VAL, primary PE only
+ *          2. Prerequisite - None
+ *
+ * @param   addr    - start address of the range
+ * @param   size    - size of the range in bytes
+ * @param   type    - CLEAN, INVALIDATE or CLEAN_AND_INVALIDATE
+ *
+ * @return  None
+ */
+void val_data_cache_ops_batch_add(addr_t addr, uint64_t size, uint32_t type)
+{
+
+    uint32_t i;
+    uint64_t line_size;
+    addr_t start, end;
+    VAL_CACHE_OPS_RANGE_t *range;
+
+    line_size = 4 << ((val_pe_reg_read(CTR_EL0) >> 16) & 0xf);
+    start = addr & ~(line_size - 1);
+    end = (addr + size + line_size - 1) & ~(line_size - 1);
+
+    for (i = 0; i < g_cache_ops_batch_cnt; i++) {
+        range = &g_cache_ops_batch[i];
+        if ((range->type != type) && (start <= range->end) && (end >= range->start)) {
+            val_data_cache_ops_batch_flush();
+            break;
+        }
+    }
+
+    /* Absorb every overlapping range into the request, rescanning after each
+     * one as the grown request may now reach ranges already looked at
+     */
+    i = 0;
+    while (i < g_cache_ops_batch_cnt) {
+        range = &g_cache_ops_batch[i];
+        if ((start <= range->end) && (end >= range->start)) {
+            if (range->start < start)
+                start = range->start;
+            if (range->end > end)
+                end = range->end;
+            *range = g_cache_ops_batch[--g_cache_ops_batch_cnt];
+            i = 0;
+            continue;
+        }
+        i++;
+    }
+
+    if (g_cache_ops_batch_cnt == CACHE_OPS_BATCH_MAX)
+        val_data_cache_ops_batch_flush();
+
+    range = &g_cache_ops_batch[g_cache_ops_batch_cnt++];
+    range->start = start;
+    range->end = end;
+    range->type = type;
+}
+
+/**
+ * @brief   Issue the cache maintenance operations queued by
+ *          val_data_cache_ops_batch_add, one range at a time
+ *
+ * @param   None
+ *
+ * @return  None
+ */
+void val_data_cache_ops_batch_flush(void)
+{
+
+    uint32_t i;
+
+    for (i = 0; i < g_cache_ops_batch_cnt; i++)
+        val_data_cache_ops_by_range(g_cache_ops_batch[i].start,
+                                    g_cache_ops_batch[i].end - g_cache_ops_batch[i].start,
+                                    g_cache_ops_batch[i].type);
+
+    g_cache_ops_batch_cnt = 0;
+}
+
 /**
  * @brief   Issues memory barrier to ensure ordering of the instructions
  */
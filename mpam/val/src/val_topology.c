@@ -0,0 +1,189 @@
+/** @file
+ * Copyright (c) 2018, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#include "include/val_infra.h"
+#include "include/val_node_infra.h"
+#include "include/val_topology.h"
+
+extern PE_INFO_TABLE *g_pe_info_table;
+extern MPAM_INFO_TABLE *g_mpam_info_table;
+
+/**
+ * @brief   Check if a PE is within the scope of a cache scope descriptor
+ *
+ * @param   pe_index    - index of the PE
+ * @param   scope       - scope of the cache, one of CACHE_NODE_SCOPE
+ * @param   scope_index - cluster id for cluster scope, Aff0 for private scope
+ * @return  1 if the PE is within the scope, else 0
+ */
+static uint8_t val_topology_pe_in_scope(uint32_t pe_index, uint32_t scope, uint32_t scope_index)
+{
+
+    uint64_t mpidr;
+    uint64_t my_mpidr;
+
+    mpidr = g_pe_info_table->pe_info[pe_index].mpidr;
+    my_mpidr = val_pe_get_mpid_index(val_pe_get_index_mpid(val_pe_get_mpid()));
+
+    switch (scope) {
+        case CACHE_SCOPE_SYSTEM:
+            return 1;
+        case CACHE_SCOPE_CLUSTER:
+            return (MPIDR_CLUSTER_ID(mpidr) == scope_index);
+        case CACHE_SCOPE_PRIVATE:
+            /* Private caches in the table of this PE belong to a PE of its cluster */
+            return ((MPIDR_CLUSTER_ID(mpidr) == MPIDR_CLUSTER_ID(my_mpidr)) &&
+                    (MPIDR_AFF0(mpidr) == scope_index));
+        default:
+            return 0;
+    }
+}
+
+/**
+ * @brief   This API checks if the traffic of a PE is handled by the input cache node
+ *          1. Caller       -  Test Suite
+ *          2. Prerequisite -  val_pe_create_info_table, val_mpam_create_info_table
+ * @param   pe_index    - index of the PE
+ * @param   node_index  - index of the cache node in the table of the current PE
+ * @return  1 if the PE is behind the cache node, else 0
+ */
+uint8_t val_topology_pe_shares_cache(uint32_t pe_index, uint32_t node_index)
+{
+
+    CACHE_NODE_ENTRY *node;
+
+    if ((g_mpam_info_table == NULL) || (pe_index >= val_pe_get_num()) ||
+        (node_index >= val_node_get_total(MPAM_NODE_CACHE)))
+        return 0;
+
+    node = &g_mpam_info_table[val_pe_get_index_mpid(val_pe_get_mpid())].cache_node[node_index];
+
+    return val_topology_pe_in_scope(pe_index, node->info.node_scope, node->info.scope_index);
+}
+
+/**
+ * @brief   This API checks if a PE is in the proximity domain of the input memory node.
+ *          A PE without a proximity domain, as on platforms without SRAT, is taken
+ *          to be local to all memory nodes.
+ *          1. Caller       -  Test Suite
+ *          2. Prerequisite -  val_pe_create_info_table, val_mpam_create_info_table
+ * @param   pe_index    - index of the PE
+ * @param   node_index  - index of the memory node
+ * @return  1 if the PE is local to the memory node, else 0
+ */
+uint8_t val_topology_pe_is_memory_local(uint32_t pe_index, uint32_t node_index)
+{
+
+    uint32_t domain;
+
+    if ((g_mpam_info_table == NULL) || (pe_index >= val_pe_get_num()) ||
+        (node_index >= val_node_get_total(MPAM_NODE_MEMORY)))
+        return 0;
+
+    domain = g_pe_info_table->pe_info[pe_index].proximity_domain;
+    if (domain == PROXIMITY_DOMAIN_UNKNOWN)
+        return 1;
+
+    return (g_mpam_info_table[val_pe_get_index_mpid(val_pe_get_mpid())].memory_node[node_index].proximity_domain
+             == domain);
+}
+
+/**
+ * @brief   This API returns the PEs whose traffic is handled by the input cache node
+ *          1. Caller       -  Test Suite
+ *          2. Prerequisite -  val_pe_create_info_table, val_mpam_create_info_table
+ * @param   node_index  - index of the cache node in the table of the current PE
+ * @param   pe_list     - array filled with the PE indices, may be NULL
+ * @param   max_cnt     - number of entries in pe_list
+ * @return  Number of PEs behind the cache node
+ */
+uint32_t val_topology_get_cache_pes(uint32_t node_index, uint32_t *pe_list, uint32_t max_cnt)
+{
+
+    uint32_t pe_index;
+    uint32_t count = 0;
+
+    for (pe_index = 0; pe_index < val_pe_get_num(); pe_index++) {
+        if (val_topology_pe_shares_cache(pe_index, node_index)) {
+            if (pe_list && (count < max_cnt))
+                pe_list[count] = pe_index;
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief   This API returns the PEs local to the input memory node
+ *          1. Caller       -  Test Suite
+ *          2. Prerequisite -  val_pe_create_info_table, val_mpam_create_info_table
+ * @param   node_index  - index of the memory node
+ * @param   pe_list     - array filled with the PE indices, may be NULL
+ * @param   max_cnt     - number of entries in pe_list
+ * @return  Number of PEs local to the memory node
+ */
+uint32_t val_topology_get_memory_pes(uint32_t node_index, uint32_t *pe_list, uint32_t max_cnt)
+{
+
+    uint32_t pe_index;
+    uint32_t count = 0;
+
+    for (pe_index = 0; pe_index < val_pe_get_num(); pe_index++) {
+        if (val_topology_pe_is_memory_local(pe_index, node_index)) {
+            if (pe_list && (count < max_cnt))
+                pe_list[count] = pe_index;
+            count++;
+        }
+    }
+
+    return count;
+}
+
+/**
+ * @brief   This API returns the number of other PEs sharing a level of the
+ *          topology with the input PE
+ *          1. Caller       -  Test Suite
+ *          2. Prerequisite -  val_pe_create_info_table
+ * @param   pe_index    - index of the PE
+ * @param   node_scope  - CACHE_SCOPE_CLUSTER or CACHE_SCOPE_SYSTEM
+ * @return  Number of sibling PEs, 0 for CACHE_SCOPE_PRIVATE
+ */
+uint32_t val_topology_get_sibling_cnt(uint32_t pe_index, uint32_t node_scope)
+{
+
+    uint32_t index;
+    uint32_t count = 0;
+    uint64_t cluster_id;
+
+    if ((g_pe_info_table == NULL) || (pe_index >= val_pe_get_num()))
+        return 0;
+
+    cluster_id = MPIDR_CLUSTER_ID(g_pe_info_table->pe_info[pe_index].mpidr);
+
+    for (index = 0; index < val_pe_get_num(); index++) {
+        if (index == pe_index)
+            continue;
+
+        if ((node_scope == CACHE_SCOPE_SYSTEM) ||
+            ((node_scope == CACHE_SCOPE_CLUSTER) &&
+             (MPIDR_CLUSTER_ID(g_pe_info_table->pe_info[index].mpidr) == cluster_id)))
+            count++;
+    }
+
+    return count;
+}
@@ -21,7 +21,11 @@
 #define SDEI_APP_VERSION_MAJOR  1
 #define SDEI_APP_VERSION_MINOR  0
 
-#define SDEI_NUM_TESTS 50
+#define SDEI_NUM_TESTS 54
+
+/* Must match the enable bitmap size in val_test_infra.h */
+#define SDEI_TEST_FLAG_WORDS \
+    (((SDEI_NUM_TESTS + 63) / 64) > 2 ? ((SDEI_NUM_TESTS + 63) / 64) : 2)
 
 #define SDEI_PASS  0
 #define SDEI_SKIP  1
@@ -37,7 +41,7 @@ typedef struct sdei_log_control {
 
 typedef struct sdei_test_control {
 	/* which tests to run? */
-    test_flags flags[2];
+    test_flags flags[SDEI_TEST_FLAG_WORDS];
     unsigned int tests_skipped;
     unsigned int tests_passed;
     unsigned int tests_failed;
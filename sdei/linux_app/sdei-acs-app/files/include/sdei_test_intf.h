@@ -25,6 +25,9 @@
 #define SDEI_TEST_COMPLETE 0xFFFFFFFF
 #define SDEI_TEST_CLEANUP    0xAAAAAAAA
 
+/* Interval between two reads of the test status and messages from /proc */
+#define SDEI_PROC_POLL_US    10000
+
 /* Function Prototypes */
 void testlib_enable_test(sdei_control_t *control, int test_id);
 void testlib_disable_test(sdei_control_t *control, int test_id);
@@ -33,9 +33,11 @@ static inline void disable_test(sdei_test_control *control, int i) {
 
 void testlib_run_specific(sdei_control_t *control, int test_id, int count)
 {
+    int i;
+
     if (count == 1) {
-        control->tst_control.flags[0] = 0ULL;
-        control->tst_control.flags[1] = 0ULL;
+        for (i = 0; i < SDEI_TEST_FLAG_WORDS; i++)
+            control->tst_control.flags[i] = 0ULL;
     }
 
     if (test_id <= SDEI_NUM_TESTS)
@@ -57,6 +59,7 @@ void testlib_disable_test(sdei_control_t *control, int test_id) {
 int init_test_env(sdei_control_t *control)
 {
     FILE *fd = NULL;
+    int i;
 
     fd = fopen("/proc/sdei", "rw+");
     if (fd == NULL) {
@@ -69,8 +72,8 @@ int init_test_env(sdei_control_t *control)
     control->tst_control.tests_failed = 0;
     control->tst_control.tests_skipped = 0;
     control->tst_control.tests_aborted = 0;
-    control->tst_control.flags[0] = ~(0ULL);
-    control->tst_control.flags[1] = ~(0ULL);
+    for (i = 0; i < SDEI_TEST_FLAG_WORDS; i++)
+        control->tst_control.flags[i] = ~(0ULL);
     control->log_control.log_file_handle = NULL;
     control->log_control.print_level = 3;
 
@@ -97,7 +100,6 @@ void read_msg_from_proc_sdei(void)
 {
     FILE *fd = NULL;
     char buf_msg[sizeof(sdei_msg_parms_t)];
-    sdei_msg_parms_t msg_params;
 
     fd = fopen("/proc/sdei_msg", "r");
     if (fd == NULL) {
@@ -132,11 +134,15 @@ int testlib_execute_tests(sdei_control_t *control)
     testlib_disable_test(control, 47);
 
     fwrite(control, 1, sizeof(struct sdei_control), fd);
+    fflush(fd);
 
     if (control->log_control.print_level != ACS_LOG_KERNEL) {
+        /* Sleep between reads instead of spinning on /proc */
         while (test_status != SDEI_TEST_COMPLETE) {
             fread(&test_status, sizeof(test_status), 1, fd);
             read_msg_from_proc_sdei();
+            if (test_status != SDEI_TEST_COMPLETE)
+                usleep(SDEI_PROC_POLL_US);
         }
     }
 
@@ -52,4 +52,7 @@ DataCacheInvalidateVA(UINT64 Address);
 VOID
 pal_print(UINT32 verbosity, CHAR8 *str, ...);
 
+UINT64
+pal_acpi_get_table(UINT32 Signature, UINT32 Instance);
+
 #endif /* __PAL_UEFI_H__ */
@@ -58,168 +58,240 @@ pal_get_xsdt_ptr()
 
 }
 
+/* Tables indexed by signature, the slots are open addressed. XSDT entries
+ * past ACPI_INDEX_MAX_TABLES are not indexed and are searched on lookup.
+ */
+#define ACPI_INDEX_MAX_TABLES   64
+#define ACPI_INDEX_SLOT_SHIFT   7
+#define ACPI_INDEX_SLOTS        (1 << ACPI_INDEX_SLOT_SHIFT)
+
+typedef struct {
+  UINT32  Signature;
+  UINT32  Count;      /* Instances of the signature */
+  UINT32  First;      /* First instance in gAcpiTables */
+} ACPI_INDEX_SLOT;
+
+static ACPI_INDEX_SLOT gAcpiIndex[ACPI_INDEX_SLOTS];
+static UINT64          gAcpiTables[ACPI_INDEX_MAX_TABLES];
+static BOOLEAN         gAcpiIndexCreated;
+static UINT64          *gAcpiEntry64;
+static UINT32          gAcpiEntry64Num;
+
+/**
+  @brief  Return the index slot of a signature, or the free slot it would take
+
+  @param  Signature  ACPI table signature
+
+  @return Index slot
+**/
+static
+ACPI_INDEX_SLOT *
+pal_acpi_index_slot(UINT32 Signature)
+{
+  UINT32  Slot;
+
+  Slot = (Signature * 0x9E3779B1) >> (32 - ACPI_INDEX_SLOT_SHIFT);
+  while (gAcpiIndex[Slot].Signature != 0 && gAcpiIndex[Slot].Signature != Signature) {
+    Slot = (Slot + 1) & (ACPI_INDEX_SLOTS - 1);
+  }
+
+  return &gAcpiIndex[Slot];
+}
+
 /**
-  @brief  Iterate through the tables pointed by XSDT and return FADT Table address
+  @brief  Walk the XSDT once and index every table by signature. The instances
+          of a signature are kept in XSDT order. Checksums are verified here,
+          a table with a bad checksum is reported and still indexed.
 
   @param  None
 
-  @return 64-bit FADT address
+  @return None
 **/
-UINT64
-pal_get_fadt_ptr()
+VOID
+pal_acpi_index_create()
 {
   EFI_ACPI_DESCRIPTION_HEADER   *Xsdt;
+  EFI_ACPI_DESCRIPTION_HEADER   *Table;
+  ACPI_INDEX_SLOT               *Slot;
   UINT64                        *Entry64;
   UINT32                        Entry64Num;
   UINT32                        Idx;
+  UINT32                        Next;
+
+  gAcpiIndexCreated = TRUE;
+  gAcpiEntry64Num = 0;
+  SetMem(gAcpiIndex, sizeof(gAcpiIndex), 0);
 
   Xsdt = (EFI_ACPI_DESCRIPTION_HEADER *) pal_get_xsdt_ptr();
   if (Xsdt == NULL) {
       pal_print(ACS_LOG_ERR, "\n        XSDT not found");
-      return 0;
+      return;
+  }
+  if (CalculateSum8((UINT8 *)Xsdt, Xsdt->Length)) {
+      pal_print(ACS_LOG_WARN, "\n        XSDT checksum is invalid");
   }
 
   Entry64  = (UINT64 *)(Xsdt + 1);
   Entry64Num = (Xsdt->Length - sizeof(EFI_ACPI_DESCRIPTION_HEADER)) >> 3;
+  gAcpiEntry64 = Entry64;
+  gAcpiEntry64Num = Entry64Num;
+  if (Entry64Num > ACPI_INDEX_MAX_TABLES) {
+      pal_print(ACS_LOG_INFO, "\n        Indexing the first %d of %d ACPI tables",
+                ACPI_INDEX_MAX_TABLES, Entry64Num);
+      Entry64Num = ACPI_INDEX_MAX_TABLES;
+  }
+
+  /* Count the instances of every signature */
   for (Idx = 0; Idx < Entry64Num; Idx++) {
-    if (*(UINT32 *)(UINTN)(Entry64[Idx]) == EFI_ACPI_6_1_FIXED_ACPI_DESCRIPTION_TABLE_SIGNATURE) {
-        return(UINT64)(Entry64[Idx]);
+    Table = (EFI_ACPI_DESCRIPTION_HEADER *)(UINTN)(Entry64[Idx]);
+    if (Table == NULL) {
+        continue;
     }
+    if (CalculateSum8((UINT8 *)Table, Table->Length)) {
+        pal_print(ACS_LOG_WARN, "\n        Checksum of ACPI table 0x%x is invalid",
+                  Table->Signature);
+    }
+    Slot = pal_acpi_index_slot(Table->Signature);
+    Slot->Signature = Table->Signature;
+    Slot->Count++;
   }
 
-  return 0;
+  /* Give every signature a run of entries, then fill them in XSDT order */
+  for (Idx = 0, Next = 0; Idx < ACPI_INDEX_SLOTS; Idx++) {
+    gAcpiIndex[Idx].First = Next;
+    Next += gAcpiIndex[Idx].Count;
+    gAcpiIndex[Idx].Count = 0;
+  }
 
+  for (Idx = 0; Idx < Entry64Num; Idx++) {
+    Table = (EFI_ACPI_DESCRIPTION_HEADER *)(UINTN)(Entry64[Idx]);
+    if (Table == NULL) {
+        continue;
+    }
+    Slot = pal_acpi_index_slot(Table->Signature);
+    gAcpiTables[Slot->First + Slot->Count++] = Entry64[Idx];
+  }
 }
 
 /**
-  @brief  Iterate through the tables pointed by XSDT and return SDEI Table address
+  @brief  Search the XSDT entries past the index for an instance of a signature
 
-  @param  None
+  @param  Signature  ACPI table signature
+  @param  Instance   Instance of the signature among the entries not indexed
 
-  @return 64-bit SDEI address
+  @return 64-bit table address, 0 if not present
 **/
+static
 UINT64
-pal_get_sdei_ptr()
+pal_acpi_scan_tables(UINT32 Signature, UINT32 Instance)
 {
-  EFI_ACPI_DESCRIPTION_HEADER   *Xsdt;
-  UINT64                        *Entry64;
-  UINT32                        Entry64Num;
+  EFI_ACPI_DESCRIPTION_HEADER   *Table;
   UINT32                        Idx;
 
-  Xsdt = (EFI_ACPI_DESCRIPTION_HEADER *) pal_get_xsdt_ptr();
-  if (Xsdt == NULL) {
-      pal_print(ACS_LOG_ERR, "\n        XSDT not found");
-      return 0;
-  }
-
-  Entry64  = (UINT64 *)(Xsdt + 1);
-  Entry64Num = (Xsdt->Length - sizeof(EFI_ACPI_DESCRIPTION_HEADER)) >> 3;
-  for (Idx = 0; Idx < Entry64Num; Idx++) {
-    if (*(UINT32 *)(UINTN)(Entry64[Idx]) == EFI_ACPI_6_2_SOFTWARE_DELEGATED_EXCEPTIONS_INTERFACE_TABLE_SIGNATURE) {
-        return(UINT64)(Entry64[Idx]);
+  for (Idx = ACPI_INDEX_MAX_TABLES; Idx < gAcpiEntry64Num; Idx++) {
+    Table = (EFI_ACPI_DESCRIPTION_HEADER *)(UINTN)(gAcpiEntry64[Idx]);
+    if (Table == NULL || Table->Signature != Signature) {
+        continue;
+    }
+    if (Instance-- == 0) {
+        return gAcpiEntry64[Idx];
     }
   }
 
   return 0;
-
 }
 
 /**
-  @brief  Iterate through the tables pointed by XSDT and return MADT address
+  @brief  Look up an ACPI table in the signature index. The index is created
+          on the first lookup. Instances not in the index are searched in the
+          rest of the XSDT.
 
-  @param  None
+  @param  Signature  ACPI table signature
+  @param  Instance   Instance of the signature, 0 for the first table
 
-  @return 64-bit MADT address
+  @return 64-bit table address, 0 if not present
 **/
 UINT64
-pal_get_madt_ptr()
+pal_acpi_get_table(UINT32 Signature, UINT32 Instance)
 {
+  ACPI_INDEX_SLOT   *Slot;
 
-  EFI_ACPI_DESCRIPTION_HEADER   *Xsdt;
-  UINT64                        *Entry64;
-  UINT32                        Entry64Num;
-  UINT32                        Idx;
-
-  Xsdt = (EFI_ACPI_DESCRIPTION_HEADER *) pal_get_xsdt_ptr();
-  if (Xsdt == NULL) {
-      pal_print(ACS_LOG_ERR, "\n        XSDT not found");
-      return 0;
+  if (!gAcpiIndexCreated) {
+      pal_acpi_index_create();
   }
 
-  Entry64  = (UINT64 *)(Xsdt + 1);
-  Entry64Num = (Xsdt->Length - sizeof(EFI_ACPI_DESCRIPTION_HEADER)) >> 3;
-  for (Idx = 0; Idx < Entry64Num; Idx++) {
-    if (*(UINT32 *)(UINTN)(Entry64[Idx]) == EFI_ACPI_6_1_MULTIPLE_APIC_DESCRIPTION_TABLE_SIGNATURE) {
-        return(UINT64)(Entry64[Idx]);
-    }
+  Slot = pal_acpi_index_slot(Signature);
+  if (Slot->Signature != Signature) {
+      return pal_acpi_scan_tables(Signature, Instance);
+  }
+  if (Instance >= Slot->Count) {
+      return pal_acpi_scan_tables(Signature, Instance - Slot->Count);
   }
 
-  return 0;
-
+  return gAcpiTables[Slot->First + Instance];
 }
 
 /**
-  @brief  Iterate through the tables pointed by XSDT and return HEST address
+  @brief  Look up the FADT Table address in the ACPI table index
 
   @param  None
 
-  @return 64-bit HEST address
+  @return 64-bit FADT address
 **/
 UINT64
-pal_get_hest_ptr()
+pal_get_fadt_ptr()
 {
+  return pal_acpi_get_table(EFI_ACPI_6_1_FIXED_ACPI_DESCRIPTION_TABLE_SIGNATURE, 0);
+}
 
-  EFI_ACPI_DESCRIPTION_HEADER   *Xsdt;
-  UINT64                        *Entry64;
-  UINT32                        Entry64Num;
-  UINT32                        Idx;
+/**
+  @brief  Look up the SDEI Table address in the ACPI table index
 
-  Xsdt = (EFI_ACPI_DESCRIPTION_HEADER *) pal_get_xsdt_ptr();
-  if (Xsdt == NULL) {
-      pal_print(ACS_LOG_ERR, "\n        XSDT not found");
-      return 0;
-  }
+  @param  None
 
-  Entry64  = (UINT64 *)(Xsdt + 1);
-  Entry64Num = (Xsdt->Length - sizeof(EFI_ACPI_DESCRIPTION_HEADER)) >> 3;
-  for (Idx = 0; Idx < Entry64Num; Idx++) {
-    if (*(UINT32 *)(UINTN)(Entry64[Idx]) == EFI_ACPI_6_1_HARDWARE_ERROR_SOURCE_TABLE_SIGNATURE) {
-        return(UINT64)(Entry64[Idx]);
-    }
-  }
-  return 0;
+  @return 64-bit SDEI address
+**/
+UINT64
+pal_get_sdei_ptr()
+{
+  return pal_acpi_get_table(EFI_ACPI_6_2_SOFTWARE_DELEGATED_EXCEPTIONS_INTERFACE_TABLE_SIGNATURE, 0);
 }
 
 /**
-  @brief  Iterate through the tables pointed by XSDT and return GTDT address
+  @brief  Look up the MADT address in the ACPI table index
 
   @param  None
 
-  @return 64-bit GTDT address
+  @return 64-bit MADT address
 **/
 UINT64
-pal_get_gtdt_ptr()
+pal_get_madt_ptr()
 {
+  return pal_acpi_get_table(EFI_ACPI_6_1_MULTIPLE_APIC_DESCRIPTION_TABLE_SIGNATURE, 0);
+}
 
-  EFI_ACPI_DESCRIPTION_HEADER   *Xsdt;
-  UINT64                        *Entry64;
-  UINT32                        Entry64Num;
-  UINT32                        Idx;
+/**
+  @brief  Look up the HEST address in the ACPI table index
 
-  Xsdt = (EFI_ACPI_DESCRIPTION_HEADER *) pal_get_xsdt_ptr();
-  if (Xsdt == NULL) {
-      pal_print(ACS_LOG_ERR, "\n        XSDT not found");
-      return 0;
-  }
+  @param  None
 
-  Entry64  = (UINT64 *)(Xsdt + 1);
-  Entry64Num = (Xsdt->Length - sizeof(EFI_ACPI_DESCRIPTION_HEADER)) >> 3;
-  for (Idx = 0; Idx < Entry64Num; Idx++) {
-    if (*(UINT32 *)(UINTN)(Entry64[Idx]) == EFI_ACPI_6_1_GENERIC_TIMER_DESCRIPTION_TABLE_SIGNATURE) {
-        return(UINT64)(Entry64[Idx]);
-    }
-  }
+  @return 64-bit HEST address
+**/
+UINT64
+pal_get_hest_ptr()
+{
+  return pal_acpi_get_table(EFI_ACPI_6_1_HARDWARE_ERROR_SOURCE_TABLE_SIGNATURE, 0);
+}
 
-  return 0;
+/**
+  @brief  Look up the GTDT address in the ACPI table index
 
+  @param  None
+
+  @return 64-bit GTDT address
+**/
+UINT64
+pal_get_gtdt_ptr()
+{
+  return pal_acpi_get_table(EFI_ACPI_6_1_GENERIC_TIMER_DESCRIPTION_TABLE_SIGNATURE, 0);
 }
@@ -316,6 +316,48 @@ int pal_pe_execute_on_all(int num_pe, VOID *payload, UINT64 arg) {
     return 0;
 }
 
+/**
+  @brief  Runs the payload on all PEs at the same time. The payload is posted to
+          every secondary PE first, then run on the calling PE, and the call
+          returns once all secondary PEs have finished.
+
+  @param  num_pe   Number of PEs
+  @param  payload  Function to run
+  @param  arg      Argument passed to the payload
+
+  @return  0
+**/
+int pal_pe_execute_on_all_concurrent(int num_pe, VOID *payload, UINT64 arg) {
+    int i;
+    UINT64 *Addr, MyMpidr = ArmReadMpidr() & (~(0xffULL << 24));
+    pe_info_entry_t *Ptr = gPeTable->pe_info;
+
+    for (i = 0; i < num_pe; i++, Ptr++) {
+       if (MyMpidr == Ptr->mpidr)
+           continue;
+       Addr = (UINT64*)PeStackTop(i);
+       *(Addr+1) = arg;
+       *Addr = (UINT64)payload;
+       DataCacheCleanInvalidateVA((UINT64)(Addr + 1));
+       DataCacheCleanInvalidateVA((UINT64)Addr);
+    }
+
+    ((VOID(*)(VOID*))payload)((VOID*)arg);
+
+    Ptr = gPeTable->pe_info;
+    for (i = 0; i < num_pe; i++, Ptr++) {
+       if (MyMpidr == Ptr->mpidr)
+           continue;
+       Addr = (UINT64*)PeStackTop(i);
+       while (1) {
+           DataCacheInvalidateVA((UINT64)Addr);
+           if (*Addr == 0)
+               break;
+       }
+    }
+    return 0;
+}
+
 void pal_pe_clean_up() {
     for (int i = 1; i < gPeTable->header.num_of_pe; i++) {
         PeSetData((UINT64*)PeStackTop(i), (UINT64)PowerOffPe, 0);
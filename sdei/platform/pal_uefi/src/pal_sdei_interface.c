@@ -185,6 +185,21 @@ int pal_acpi_present(void)
     return TRUE;
 }
 
+/**
+  @brief  Raise a platform SDEI event, such as a critical RAS error event,
+          from the normal world. There is no architected way to do this, a
+          platform can implement it through its error injection interface.
+
+  @param  event_num  SDEI event number to raise
+
+  @return 0 on success, SDEI_STATUS_NOT_SUPPORTED if the platform cannot
+          raise the event
+**/
+int pal_sdei_event_trigger(uint32_t event_num)
+{
+    return SDEI_STATUS_NOT_SUPPORTED;
+}
+
 /*
  * Read ACPI Hardware Error Source table and intialize the event info
  * table with event numbers read from Generic Hardware Error Source
@@ -46,4 +46,5 @@ static void test_entry(void)
 }
 
 SDEI_SET_TEST_DEPS(test_002_deps, TEST_NONE_ID);
-SDEI_PUBLISH_TEST(test_002, TEST_002_ID, TEST_DESC, test_002_deps, test_entry, FALSE);
+SDEI_PUBLISH_TEST_RES(test_002, TEST_002_ID, TEST_DESC, test_002_deps, test_entry, FALSE,
+                      SDEI_RES_NONE);
@@ -118,4 +118,5 @@ static void test_entry(void)
 }
 
 SDEI_SET_TEST_DEPS(test_004_deps, TEST_NONE_ID);
-SDEI_PUBLISH_TEST(test_004, TEST_004_ID, TEST_DESC, test_004_deps, test_entry, FALSE);
+SDEI_PUBLISH_TEST_RES(test_004, TEST_004_ID, TEST_DESC, test_004_deps, test_entry, FALSE,
+                      SDEI_RES_SPI | SDEI_RES_PPI);
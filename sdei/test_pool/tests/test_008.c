@@ -31,4 +31,5 @@ static void test_entry(void)
 }
 
 SDEI_SET_TEST_DEPS(test_008_deps, TEST_NONE_ID);
-SDEI_PUBLISH_TEST(test_008, TEST_008_ID, TEST_DESC, test_008_deps, test_entry, FALSE);
+SDEI_PUBLISH_TEST_RES(test_008, TEST_008_ID, TEST_DESC, test_008_deps, test_entry, FALSE,
+                      SDEI_RES_NONE);
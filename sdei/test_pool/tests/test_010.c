@@ -82,4 +82,5 @@ static void test_entry(void)
 }
 
 SDEI_SET_TEST_DEPS(test_010_deps, TEST_001_ID);
-SDEI_PUBLISH_TEST(test_010, TEST_010_ID, TEST_DESC, test_010_deps, test_entry, FALSE);
+SDEI_PUBLISH_TEST_RES(test_010, TEST_010_ID, TEST_DESC, test_010_deps, test_entry, FALSE,
+                      SDEI_RES_SPI | SDEI_RES_PPI);
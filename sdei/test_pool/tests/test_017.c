@@ -62,4 +62,5 @@ static void test_entry(void)
 }
 
 SDEI_SET_TEST_DEPS(test_017_deps, TEST_NONE_ID);
-SDEI_PUBLISH_TEST(test_017, TEST_017_ID, TEST_DESC, test_017_deps, test_entry, FALSE);
+SDEI_PUBLISH_TEST_RES(test_017, TEST_017_ID, TEST_DESC, test_017_deps, test_entry, FALSE,
+                      SDEI_RES_NONE);
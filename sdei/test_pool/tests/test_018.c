@@ -59,4 +59,5 @@ static void test_entry(void)
 }
 
 SDEI_SET_TEST_DEPS(test_018_deps, TEST_NONE_ID);
-SDEI_PUBLISH_TEST(test_018, TEST_018_ID, TEST_DESC, test_018_deps, test_entry, FALSE);
+SDEI_PUBLISH_TEST_RES(test_018, TEST_018_ID, TEST_DESC, test_018_deps, test_entry, FALSE,
+                      SDEI_RES_NONE);
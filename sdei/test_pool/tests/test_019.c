@@ -41,4 +41,5 @@ static void test_entry(void)
 }
 
 SDEI_SET_TEST_DEPS(test_019_deps, TEST_001_ID, TEST_002_ID);
-SDEI_PUBLISH_TEST(test_019, TEST_019_ID, TEST_DESC, test_019_deps, test_entry, FALSE);
+SDEI_PUBLISH_TEST_RES(test_019, TEST_019_ID, TEST_DESC, test_019_deps, test_entry, FALSE,
+                      SDEI_RES_NONE);
@@ -41,4 +41,5 @@ static void test_entry(void) {
 }
 
 SDEI_SET_TEST_DEPS(test_020_deps, TEST_001_ID, TEST_002_ID);
-SDEI_PUBLISH_TEST(test_020, TEST_020_ID, TEST_DESC, test_020_deps, test_entry, FALSE);
+SDEI_PUBLISH_TEST_RES(test_020, TEST_020_ID, TEST_DESC, test_020_deps, test_entry, FALSE,
+                      SDEI_RES_NONE);
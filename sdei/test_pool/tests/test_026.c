@@ -97,4 +97,5 @@ static void test_entry(void)
 }
 
 SDEI_SET_TEST_DEPS(test_026_deps, TEST_NONE_ID);
-SDEI_PUBLISH_TEST(test_026, TEST_026_ID, TEST_DESC, test_026_deps, test_entry, FALSE);
+SDEI_PUBLISH_TEST_RES(test_026, TEST_026_ID, TEST_DESC, test_026_deps, test_entry, FALSE,
+                      SDEI_RES_HEST_EVENTS);
@@ -0,0 +1,265 @@
+/** @file
+ * Copyright (c) 2018, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+**/
+
+#include <val_interface.h>
+#include <val_sdei_interface.h>
+#include <val_benchmark.h>
+
+#define TEST_DESC "Measure SDEI call round-trip latency           "
+
+/* Event 0 is the software signalled private event, present on every PE */
+#define BENCH_EVENT 0
+
+#define BENCH_MODE_IDLE       0
+#define BENCH_MODE_CONCURRENT 1
+
+typedef enum {
+    CALL_VERSION = 0,
+    CALL_EVENT_STATUS,
+    CALL_EVENT_GET_INFO,
+    CALL_PE_MASK,
+    CALL_PE_UNMASK,
+    CALL_EVENT_REGISTER,
+    CALL_EVENT_ENABLE,
+    CALL_EVENT_DISABLE,
+    CALL_EVENT_UNREGISTER,
+    CALL_MAX
+} bench_call_t;
+
+static char *g_call_name[CALL_MAX] = {
+    "SDEI_VERSION         :",
+    "SDEI_EVENT_STATUS    :",
+    "SDEI_EVENT_GET_INFO  :",
+    "SDEI_PE_MASK         :",
+    "SDEI_PE_UNMASK       :",
+    "SDEI_EVENT_REGISTER  :",
+    "SDEI_EVENT_ENABLE    :",
+    "SDEI_EVENT_DISABLE   :",
+    "SDEI_EVENT_UNREGISTER:"
+};
+
+static uint64_t g_samples[BENCH_MAX_PE][BENCH_MAX_SAMPLES];
+static bench_stats_t g_stats[BENCH_MAX_PE][CALL_MAX];
+static uint32_t g_pe_status[BENCH_MAX_PE];
+static uint32_t g_target_pe;
+static uint32_t g_num_pe;
+
+static void event_handler(void)
+{
+}
+
+/* Brings the event and PE mask into the state the timed call expects */
+static int32_t call_setup(uint32_t call)
+{
+    int32_t err;
+    uint64_t res;
+
+    switch (call) {
+    case CALL_PE_UNMASK:
+        return val_sdei_mask(&res);
+    case CALL_EVENT_ENABLE:
+    case CALL_EVENT_DISABLE:
+    case CALL_EVENT_UNREGISTER:
+        err = val_sdei_event_register(BENCH_EVENT, (uint64_t)asm_event_handler,
+                                      (void *)event_handler, SDEI_EVENT_REGISTER_RM_ANY, 0);
+        if (err || call != CALL_EVENT_DISABLE)
+            return err;
+        return val_sdei_event_enable(BENCH_EVENT);
+    default:
+        return 0;
+    }
+}
+
+static int32_t call_timed(uint32_t call)
+{
+    uint64_t res;
+
+    switch (call) {
+    case CALL_VERSION:
+        return val_sdei_get_version(&res);
+    case CALL_EVENT_STATUS:
+        return val_sdei_event_status(BENCH_EVENT, &res);
+    case CALL_EVENT_GET_INFO:
+        return val_sdei_event_get_info(BENCH_EVENT, SDEI_EVENT_INFO_EV_TYPE, &res);
+    case CALL_PE_MASK:
+        return val_sdei_mask(&res);
+    case CALL_PE_UNMASK:
+        return val_sdei_unmask();
+    case CALL_EVENT_REGISTER:
+        return val_sdei_event_register(BENCH_EVENT, (uint64_t)asm_event_handler,
+                                       (void *)event_handler, SDEI_EVENT_REGISTER_RM_ANY, 0);
+    case CALL_EVENT_ENABLE:
+        return val_sdei_event_enable(BENCH_EVENT);
+    case CALL_EVENT_DISABLE:
+        return val_sdei_event_disable(BENCH_EVENT);
+    case CALL_EVENT_UNREGISTER:
+        return val_sdei_event_unregister(BENCH_EVENT);
+    default:
+        return SDEI_STATUS_INVALID;
+    }
+}
+
+/* Returns the event and PE mask to their initial state */
+static int32_t call_teardown(uint32_t call)
+{
+    switch (call) {
+    case CALL_PE_MASK:
+        return val_sdei_unmask();
+    case CALL_EVENT_REGISTER:
+    case CALL_EVENT_ENABLE:
+    case CALL_EVENT_DISABLE:
+        return val_sdei_event_unregister(BENCH_EVENT);
+    default:
+        return 0;
+    }
+}
+
+/* Times every call on the current PE. Nothing is printed here, secondary PEs
+ * run with a small stack.
+ */
+static uint32_t measure_calls(uint32_t index, uint32_t mode)
+{
+    uint32_t call, iter;
+    uint64_t start;
+    int32_t err;
+
+    for (call = 0; call < CALL_MAX; call++) {
+        if ((mode == BENCH_MODE_CONCURRENT) && val_bench_pe_barrier(g_num_pe, call + 1))
+            return SDEI_TEST_ERROR;
+
+        for (iter = 0; iter < BENCH_MAX_SAMPLES; iter++) {
+            if (call_setup(call))
+                return SDEI_TEST_FAIL;
+
+            start = val_bench_read_counter();
+            err = call_timed(call);
+            g_samples[index][iter] = val_bench_read_counter() - start;
+
+            if (call_teardown(call) || err)
+                return SDEI_TEST_FAIL;
+        }
+        val_bench_get_stats(g_samples[index], BENCH_MAX_SAMPLES, &g_stats[index][call]);
+    }
+
+    return SDEI_TEST_PASS;
+}
+
+static void payload(void *arg)
+{
+    uint32_t mode = (uint64_t)arg;
+    uint32_t index = val_pe_get_index();
+
+    if (index >= g_num_pe)
+        return;
+
+    /* In idle mode only the target PE issues calls, the others stay quiet */
+    if ((mode == BENCH_MODE_IDLE) && (index != g_target_pe))
+        return;
+
+    g_pe_status[index] = measure_calls(index, mode);
+    if (g_pe_status[index] != SDEI_TEST_PASS) {
+        /* Leave the PE unmasked with the event free for the tests that follow */
+        val_sdei_event_unregister(BENCH_EVENT);
+        val_sdei_unmask();
+    }
+    val_bench_sync_range(g_stats[index], sizeof(g_stats[index]));
+    val_bench_sync_range(&g_pe_status[index], sizeof(g_pe_status[index]));
+}
+
+static uint32_t report(char *title)
+{
+    uint32_t call, index, worst_pe, status = SDEI_TEST_PASS;
+    bench_stats_t summary;
+
+    val_bench_sync_range(g_stats, sizeof(g_stats));
+    val_bench_sync_range(g_pe_status, sizeof(g_pe_status));
+
+    for (index = 0; index < g_num_pe; index++) {
+        if (g_pe_status[index] != SDEI_TEST_PASS) {
+            val_print(ACS_LOG_ERR, "\n        SDEI calls failed on PE %d", index);
+            status |= g_pe_status[index];
+        }
+    }
+    if (status != SDEI_TEST_PASS)
+        return status;
+
+    val_print(ACS_LOG_TEST, "\n        " BENCH_STR_FMT, (uint64_t)title);
+    for (call = 0; call < CALL_MAX; call++) {
+        summary.count = 0;
+        worst_pe = 0;
+        for (index = 0; index < g_num_pe; index++) {
+            val_bench_merge_stats(&summary, &g_stats[index][call]);
+            if (g_stats[index][call].median > g_stats[worst_pe][call].median)
+                worst_pe = index;
+        }
+        val_bench_report(ACS_LOG_TEST, g_call_name[call], &summary);
+        val_print(ACS_LOG_TEST, " slowest PE %d", worst_pe);
+    }
+
+    for (index = 0; index < g_num_pe; index++) {
+        val_print(ACS_LOG_DEBUG, "\n        PE %d", index);
+        for (call = 0; call < CALL_MAX; call++)
+            val_bench_report(ACS_LOG_DEBUG, g_call_name[call], &g_stats[index][call]);
+    }
+
+    return SDEI_TEST_PASS;
+}
+
+static void reset_pe_status(void)
+{
+    uint32_t index;
+
+    for (index = 0; index < g_num_pe; index++)
+        g_pe_status[index] = SDEI_TEST_PENDING;
+    val_bench_sync_range(g_pe_status, sizeof(g_pe_status));
+}
+
+static void test_entry(void)
+{
+    uint32_t status;
+
+    g_num_pe = val_pe_get_num();
+    if (g_num_pe > BENCH_MAX_PE) {
+        val_print(ACS_LOG_WARN, "\n        Measuring the first %d PEs only", BENCH_MAX_PE);
+        g_num_pe = BENCH_MAX_PE;
+    }
+    val_bench_sync_range(&g_num_pe, sizeof(g_num_pe));
+
+    /* Each PE alone, the rest of the system idle */
+    reset_pe_status();
+    for (g_target_pe = 0; g_target_pe < g_num_pe; g_target_pe++) {
+        val_bench_sync_range(&g_target_pe, sizeof(g_target_pe));
+        val_pe_execute_on_all((void *)payload, BENCH_MODE_IDLE);
+    }
+
+    status = report("Idle, one PE at a time (ns)");
+    if (status != SDEI_TEST_PASS) {
+        val_test_pe_set_status(val_pe_get_index(), status);
+        return;
+    }
+
+    /* All PEs issuing the same call at the same time */
+    reset_pe_status();
+    val_bench_pe_barrier_reset();
+    val_pe_execute_on_all_concurrent((void *)payload, BENCH_MODE_CONCURRENT);
+
+    status = report("All PEs concurrently (ns)");
+    val_test_pe_set_status(val_pe_get_index(), status);
+}
+
+SDEI_SET_TEST_DEPS(test_050_deps, TEST_003_ID, TEST_005_ID, TEST_006_ID, TEST_007_ID);
+SDEI_PUBLISH_TEST(test_050, TEST_050_ID, TEST_DESC, test_050_deps, test_entry, FALSE);
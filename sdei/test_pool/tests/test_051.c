@@ -0,0 +1,350 @@
+/** @file
+ * Copyright (c) 2018, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+**/
+
+#include <val_interface.h>
+#include <val_sdei_interface.h>
+#include <val_benchmark.h>
+
+#define TEST_DESC "Measure SDEI event delivery latency            "
+
+#define BENCH_ITER      64
+#define BENCH_WD_TICKS  100
+#define EVENT_NONE      0xFFFFFFFF
+
+typedef enum {
+    TRIGGER_SIGNAL = 0,
+    TRIGGER_SPI,
+    TRIGGER_WD,
+    TRIGGER_MAX
+} bench_trigger_t;
+
+typedef enum {
+    METRIC_DELIVERY = 0,
+    METRIC_RETURN,
+    METRIC_MAX
+} bench_metric_t;
+
+typedef struct {
+    char *name;
+    uint32_t trigger;
+    uint32_t resume;
+} bench_scenario_t;
+
+static bench_scenario_t g_scenario[] = {
+    {"EVENT_SIGNAL, COMPLETE              ", TRIGGER_SIGNAL, FALSE},
+    {"EVENT_SIGNAL, COMPLETE_AND_RESUME   ", TRIGGER_SIGNAL, TRUE},
+    {"Bound SPI pend, COMPLETE            ", TRIGGER_SPI, FALSE},
+    {"Bound SPI pend, COMPLETE_AND_RESUME ", TRIGGER_SPI, TRUE},
+    {"Watchdog WS0, COMPLETE              ", TRIGGER_WD, FALSE}
+};
+
+#define SCENARIO_MAX (sizeof(g_scenario) / sizeof(g_scenario[0]))
+
+static char *g_metric_name[METRIC_MAX] = {
+    "  trigger to handler entry :",
+    "  completion to resume     :"
+};
+
+static uint64_t g_samples[METRIC_MAX][BENCH_ITER];
+static bench_stats_t g_stats[BENCH_MAX_PE][SCENARIO_MAX][METRIC_MAX];
+static uint32_t g_pe_status[BENCH_MAX_PE];
+static uint32_t g_event[TRIGGER_MAX];
+static uint32_t g_target_pe;
+static uint32_t g_num_pe;
+static int32_t g_wd_num;
+static uint64_t *g_wd_addr;
+static uint64_t g_wd_intid;
+static volatile uint64_t g_entry_ts;
+static volatile uint32_t g_trigger;
+
+static void event_handler(uint64_t entry_ts)
+{
+    /* Quiesce the source before completing, WS0 would otherwise escalate */
+    if (g_trigger == TRIGGER_WD)
+        val_wd_set_ws0(g_wd_addr, g_wd_num, 0);
+    g_entry_ts = entry_ts;
+}
+
+static uint32_t fire(uint32_t trigger, uint64_t affinity, uint64_t *trigger_ts)
+{
+    switch (trigger) {
+    case TRIGGER_SIGNAL:
+        *trigger_ts = val_bench_read_counter();
+        return val_sdei_event_signal(g_event[TRIGGER_SIGNAL], affinity);
+    case TRIGGER_SPI:
+        *trigger_ts = val_bench_read_counter();
+        return val_gic_generate_interrupt(SPI_INTR_NUM);
+    case TRIGGER_WD:
+        /* WS0 asserts once the offset has elapsed from the enable write */
+        *trigger_ts = val_bench_read_counter() + BENCH_WD_TICKS;
+        val_wd_set_ws0(g_wd_addr, g_wd_num, BENCH_WD_TICKS);
+        return 0;
+    default:
+        return 1;
+    }
+}
+
+/* Takes BENCH_ITER events of one scenario on the current PE. Nothing is
+ * printed here, secondary PEs run with a small stack.
+ */
+static uint32_t measure_scenario(uint32_t index, uint32_t sc)
+{
+    uint32_t iter, event = g_event[g_scenario[sc].trigger];
+    uint64_t affinity = val_pe_get_mpid_index(index);
+    uint64_t trigger_ts, resume_ts, timeout, entry_point, flags = SDEI_EVENT_REGISTER_RM_ANY;
+    uint32_t status = SDEI_TEST_PASS;
+
+    if (event == EVENT_NONE)
+        return SDEI_TEST_PASS;
+
+    g_trigger = g_scenario[sc].trigger;
+    entry_point = g_scenario[sc].resume ? (uint64_t)asm_event_handler_timed_resume :
+                                          (uint64_t)asm_event_handler_timed;
+
+    /* Shared events are routed to the PE being measured */
+    if (g_trigger != TRIGGER_SIGNAL)
+        flags = SDEI_EVENT_REGISTER_RM_PE;
+
+    if (val_sdei_event_register(event, entry_point, (void *)event_handler, flags, affinity))
+        return SDEI_TEST_FAIL;
+
+    if (val_sdei_event_enable(event)) {
+        status = SDEI_TEST_FAIL;
+        goto event_unregister;
+    }
+
+    for (iter = 0; iter < BENCH_ITER; iter++) {
+        g_entry_ts = 0;
+        g_bench_complete_ts = 0;
+        g_bench_resume_ts = 0;
+        timeout = TIMEOUT_MEDIUM;
+
+        if (fire(g_trigger, affinity, &trigger_ts)) {
+            status = SDEI_TEST_FAIL;
+            goto event_unregister;
+        }
+
+        /* The handler interrupts this loop and completes back into it */
+        while (!g_entry_ts && timeout--)
+            ;
+        resume_ts = val_bench_read_counter();
+
+        if (!g_entry_ts) {
+            if (g_trigger == TRIGGER_WD)
+                val_wd_set_ws0(g_wd_addr, g_wd_num, 0);
+            status = SDEI_TEST_FAIL;
+            goto event_unregister;
+        }
+
+        if (g_scenario[sc].resume)
+            resume_ts = g_bench_resume_ts;
+
+        g_samples[METRIC_DELIVERY][iter] = (g_entry_ts > trigger_ts) ?
+                                           g_entry_ts - trigger_ts : 0;
+        g_samples[METRIC_RETURN][iter] = (resume_ts > g_bench_complete_ts) ?
+                                         resume_ts - g_bench_complete_ts : 0;
+    }
+
+    val_bench_get_stats(g_samples[METRIC_DELIVERY], BENCH_ITER,
+                        &g_stats[index][sc][METRIC_DELIVERY]);
+    val_bench_get_stats(g_samples[METRIC_RETURN], BENCH_ITER,
+                        &g_stats[index][sc][METRIC_RETURN]);
+
+event_unregister:
+    if (val_sdei_event_unregister(event))
+        status = SDEI_TEST_FAIL;
+    return status;
+}
+
+static void payload(void *ignore)
+{
+    uint32_t sc, index = val_pe_get_index();
+
+    /* Events are taken by one PE at a time, the rest of the system idle */
+    if ((index >= g_num_pe) || (index != g_target_pe))
+        return;
+
+    g_pe_status[index] = SDEI_TEST_PASS;
+    for (sc = 0; sc < SCENARIO_MAX; sc++) {
+        g_pe_status[index] = measure_scenario(index, sc);
+        if (g_pe_status[index] != SDEI_TEST_PASS)
+            break;
+    }
+
+    val_bench_sync_range(g_stats[index], sizeof(g_stats[index]));
+    val_bench_sync_range(&g_pe_status[index], sizeof(g_pe_status[index]));
+}
+
+static uint32_t wd_event_bind(void)
+{
+    int32_t err;
+
+    g_wd_num = val_wd_get_info(0, WD_INFO_COUNT);
+    while (g_wd_num--) {
+        if (!val_wd_get_info(g_wd_num, WD_INFO_ISSECURE))
+            break;
+    }
+    if (g_wd_num < 0) {
+        val_print(ACS_LOG_WARN, "\n        No non-secure Watchdogs, WS0 not measured");
+        return SDEI_TEST_PASS;
+    }
+
+    g_wd_intid = val_wd_get_info(g_wd_num, WD_INFO_GSIV);
+    g_wd_addr = val_pa_to_va(val_wd_get_info(g_wd_num, WD_INFO_CTRL_BASE));
+
+    err = val_gic_disable_interrupt(g_wd_intid);
+    if (err) {
+        val_print(ACS_LOG_ERR, "\n        Interrupt %lld disable failed", g_wd_intid);
+        return SDEI_TEST_FAIL;
+    }
+
+    err = val_sdei_interrupt_bind(g_wd_intid, &g_event[TRIGGER_WD]);
+    if (err) {
+        val_print(ACS_LOG_ERR, "\n        SPI intr number %lld bind failed with err %d",
+                                                                    g_wd_intid, err);
+        g_event[TRIGGER_WD] = EVENT_NONE;
+        return SDEI_TEST_FAIL;
+    }
+
+    return SDEI_TEST_PASS;
+}
+
+static uint32_t spi_event_bind(void)
+{
+    int32_t err;
+
+    err = val_gic_disable_interrupt(SPI_INTR_NUM);
+    if (err) {
+        val_print(ACS_LOG_ERR, "\n        Interrupt %d disable failed", SPI_INTR_NUM);
+        return SDEI_TEST_FAIL;
+    }
+
+    err = val_sdei_interrupt_bind(SPI_INTR_NUM, &g_event[TRIGGER_SPI]);
+    if (err) {
+        val_print(ACS_LOG_ERR, "\n        SPI intr number %d bind failed with err %d",
+                                                                    SPI_INTR_NUM, err);
+        g_event[TRIGGER_SPI] = EVENT_NONE;
+        return SDEI_TEST_FAIL;
+    }
+
+    return SDEI_TEST_PASS;
+}
+
+static void report(void)
+{
+    uint32_t sc, metric, index, worst_pe;
+    uint64_t type, priority;
+    bench_stats_t summary;
+
+    for (sc = 0; sc < SCENARIO_MAX; sc++) {
+        if (g_event[g_scenario[sc].trigger] == EVENT_NONE)
+            continue;
+
+        type = priority = 0;
+        val_sdei_event_get_info(g_event[g_scenario[sc].trigger],
+                                SDEI_EVENT_INFO_EV_TYPE, &type);
+        val_sdei_event_get_info(g_event[g_scenario[sc].trigger],
+                                SDEI_EVENT_INFO_EV_PRIORITY, &priority);
+        val_print(ACS_LOG_TEST, "\n        " BENCH_STR_FMT, (uint64_t)g_scenario[sc].name);
+        val_print(ACS_LOG_TEST, " event %d", g_event[g_scenario[sc].trigger]);
+        val_print(ACS_LOG_TEST, " type " BENCH_STR_FMT, (uint64_t)((type == SDEI_EVENT_TYPE_SHARED) ?
+                                                       "shared" : "private"));
+        val_print(ACS_LOG_TEST, " priority " BENCH_STR_FMT,
+                  (uint64_t)((priority == SDEI_EVENT_PRIORITY_CRITICAL) ? "critical" : "normal"));
+
+        for (metric = 0; metric < METRIC_MAX; metric++) {
+            summary.count = 0;
+            worst_pe = 0;
+            for (index = 0; index < g_num_pe; index++) {
+                val_bench_merge_stats(&summary, &g_stats[index][sc][metric]);
+                if (g_stats[index][sc][metric].median > g_stats[worst_pe][sc][metric].median)
+                    worst_pe = index;
+            }
+            val_bench_report(ACS_LOG_TEST, g_metric_name[metric], &summary);
+            val_print(ACS_LOG_TEST, " slowest PE %d", worst_pe);
+
+            for (index = 0; index < g_num_pe; index++) {
+                val_print(ACS_LOG_DEBUG, "\n          PE %d", index);
+                val_bench_report(ACS_LOG_DEBUG, g_metric_name[metric],
+                                 &g_stats[index][sc][metric]);
+            }
+        }
+    }
+}
+
+static void test_entry(void)
+{
+    uint32_t index, trigger, status;
+
+    g_num_pe = val_pe_get_num();
+    if (g_num_pe > BENCH_MAX_PE) {
+        val_print(ACS_LOG_WARN, "\n        Measuring the first %d PEs only", BENCH_MAX_PE);
+        g_num_pe = BENCH_MAX_PE;
+    }
+
+    /* Event 0 is the software signalled private event, present on every PE */
+    g_event[TRIGGER_SIGNAL] = 0;
+    g_event[TRIGGER_SPI] = EVENT_NONE;
+    g_event[TRIGGER_WD] = EVENT_NONE;
+    g_wd_addr = NULL;
+
+    status = spi_event_bind();
+    if (status == SDEI_TEST_PASS)
+        status = wd_event_bind();
+    if (status != SDEI_TEST_PASS)
+        goto event_release;
+
+    for (index = 0; index < g_num_pe; index++)
+        g_pe_status[index] = SDEI_TEST_PENDING;
+    val_bench_sync_range(g_pe_status, sizeof(g_pe_status));
+    val_bench_sync_range(g_event, sizeof(g_event));
+    val_bench_sync_range(&g_num_pe, sizeof(g_num_pe));
+    val_bench_sync_range(&g_wd_num, sizeof(g_wd_num));
+    val_bench_sync_range(&g_wd_addr, sizeof(g_wd_addr));
+
+    for (g_target_pe = 0; g_target_pe < g_num_pe; g_target_pe++) {
+        val_bench_sync_range(&g_target_pe, sizeof(g_target_pe));
+        val_pe_execute_on_all((void *)payload, 0);
+    }
+
+    val_bench_sync_range(g_stats, sizeof(g_stats));
+    val_bench_sync_range(g_pe_status, sizeof(g_pe_status));
+    for (index = 0; index < g_num_pe; index++) {
+        if (g_pe_status[index] != SDEI_TEST_PASS) {
+            val_print(ACS_LOG_ERR, "\n        Event delivery failed on PE %d", index);
+            status = SDEI_TEST_FAIL;
+        }
+    }
+
+    if (status == SDEI_TEST_PASS)
+        report();
+
+event_release:
+    for (trigger = TRIGGER_SPI; trigger < TRIGGER_MAX; trigger++) {
+        if (g_event[trigger] == EVENT_NONE)
+            continue;
+        if (val_sdei_interrupt_release(g_event[trigger]))
+            val_print(ACS_LOG_ERR, "\n        Event number %d release failed", g_event[trigger]);
+    }
+    if (g_wd_addr)
+        val_va_free(g_wd_addr);
+
+    val_test_pe_set_status(val_pe_get_index(), status);
+}
+
+SDEI_SET_TEST_DEPS(test_051_deps, TEST_001_ID, TEST_002_ID, TEST_033_ID);
+SDEI_PUBLISH_TEST(test_051, TEST_051_ID, TEST_DESC, test_051_deps, test_entry, FALSE);
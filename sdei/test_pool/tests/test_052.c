@@ -0,0 +1,602 @@
+/** @file
+ * Copyright (c) 2018, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+**/
+
+#include <val_interface.h>
+#include <val_sdei_interface.h>
+#include <val_benchmark.h>
+
+#define TEST_DESC "Stress concurrent SDEI event delivery          "
+
+#define BIND_SLOTS_FEATURE      0
+#define SPI_BASE                32
+/* Bound SPIs, plus the watchdog, a PPI and a critical platform event */
+#define STRESS_MAX_SPI          16
+#define STRESS_MAX_SOURCES      (STRESS_MAX_SPI + 3)
+#define STRESS_DURATION_US      1000000
+#define STRESS_EVENT_TIMEOUT_US 10000
+#define STRESS_WD_TICKS         100
+#define SIGNAL_EVENT            0
+
+typedef enum {
+    SRC_SPI = 0,
+    SRC_WD,
+    SRC_PPI,
+    SRC_EVENT       /* platform event, raised through val_sdei_event_trigger */
+} stress_kind_t;
+
+/* Bound event, fired by the driving PE */
+typedef struct {
+    uint32_t event;
+    uint32_t irq;
+    uint32_t kind;
+    uint32_t mark;
+    uint32_t enabled;
+    uint32_t restore;
+    volatile uint32_t dropped;
+    volatile uint64_t fire_ts;
+    volatile uint32_t sent;
+    volatile uint32_t received;
+} stress_source_t;
+
+/* Per PE state, written by the handler on that PE */
+typedef struct {
+    volatile uint32_t sig_sent;
+    volatile uint32_t sig_rx;
+    volatile uint32_t ppi_rx;
+    volatile uint32_t lat_count;
+    volatile uint64_t sig_ts;
+    uint64_t target_mpid;
+    uint32_t sig_mark;
+    uint32_t status;
+    uint64_t lat[BENCH_MAX_SAMPLES];
+} stress_pe_t;
+
+static stress_source_t g_src[STRESS_MAX_SOURCES];
+static stress_pe_t g_pe[BENCH_MAX_PE];
+static bench_stats_t g_stats[BENCH_MAX_PE];
+static uint32_t g_num_src;
+static uint32_t g_ppi_src;
+static uint32_t g_ppi_event;
+static uint32_t g_num_pe;
+static uint32_t g_driver_pe;
+static uint64_t g_end_ts;
+static uint64_t g_timeout;
+static int32_t g_wd_num;
+static uint64_t *g_wd_addr;
+
+static void event_handler(uint32_t event_num)
+{
+    uint64_t now = val_bench_read_counter(), fire_ts;
+    uint32_t s, index = val_pe_get_index();
+    stress_pe_t *pe;
+
+    if (index >= g_num_pe)
+        return;
+    pe = &g_pe[index];
+
+    if (event_num == SIGNAL_EVENT) {
+        /* Each PE is signalled by the PE before it */
+        fire_ts = g_pe[(index + g_num_pe - 1) % g_num_pe].sig_ts;
+        pe->sig_rx++;
+    } else {
+        for (s = 0; s < g_num_src && g_src[s].event != event_num; s++)
+            ;
+        if (s == g_num_src)
+            return;
+        if (g_src[s].kind == SRC_WD)
+            val_wd_set_ws0(g_wd_addr, g_wd_num, 0);
+        fire_ts = g_src[s].fire_ts;
+        if (g_src[s].kind == SRC_PPI)
+            pe->ppi_rx++;
+        else
+            g_src[s].received++;
+    }
+
+    pe->lat[pe->lat_count++ % BENCH_MAX_SAMPLES] = (now > fire_ts) ? now - fire_ts : 0;
+}
+
+static uint32_t source_delivered(stress_source_t *src)
+{
+    uint32_t index;
+
+    if (src->kind != SRC_PPI)
+        return src->received != src->mark;
+
+    /* A pended PPI is taken by every PE */
+    for (index = 0; index < g_num_pe; index++)
+        if (g_pe[index].ppi_rx == src->mark)
+            return 0;
+    return 1;
+}
+
+/* A source whose interrupt is still pending in the distributor has not been
+ * taken yet. Pending it again would merge with the pend in flight and count as
+ * a lost delivery. PPIs are pending in each redistributor and are not checked.
+ */
+static uint32_t source_pending(stress_source_t *src)
+{
+    uint32_t pending = 0;
+
+    if (src->kind == SRC_PPI || src->kind == SRC_EVENT)
+        return 0;
+    val_gic_get_interrupt_pending(src->irq, &pending);
+    return pending;
+}
+
+static void source_fire(stress_source_t *src, uint64_t now)
+{
+    src->mark = (src->kind == SRC_PPI) ? src->sent : src->received;
+    src->sent++;
+    if (src->kind == SRC_WD) {
+        src->fire_ts = now + STRESS_WD_TICKS;
+        val_wd_set_ws0(g_wd_addr, g_wd_num, STRESS_WD_TICKS);
+    } else if (src->kind == SRC_EVENT) {
+        src->fire_ts = now;
+        /* Without a platform trigger the event is left out of the run */
+        if (val_sdei_event_trigger(src->event)) {
+            src->sent--;
+            src->dropped = 1;
+        }
+    } else {
+        src->fire_ts = now;
+        val_gic_generate_interrupt(src->irq);
+    }
+}
+
+/* Runs on every PE at once until the end time. Each PE keeps one software
+ * signalled event in flight to the next PE, the driving PE also refires every
+ * bound event as soon as it was taken. Nothing is printed, secondary PEs run
+ * with a small stack.
+ */
+static void payload(void *ignore)
+{
+    uint32_t s, index = val_pe_get_index();
+    uint32_t target;
+    uint64_t now;
+    stress_pe_t *pe;
+
+    if (index >= g_num_pe)
+        return;
+    pe = &g_pe[index];
+    target = (index + 1) % g_num_pe;
+
+    while ((now = val_bench_read_counter()) < g_end_ts) {
+        if (g_pe[target].sig_rx != pe->sig_mark || (now - pe->sig_ts) > g_timeout ||
+            !pe->sig_sent) {
+            pe->sig_mark = g_pe[target].sig_rx;
+            pe->sig_ts = now;
+            pe->sig_sent++;
+            if (val_sdei_event_signal(SIGNAL_EVENT, pe->target_mpid))
+                pe->status = SDEI_TEST_FAIL;
+        }
+
+        if (index != g_driver_pe)
+            continue;
+
+        for (s = 0; s < g_num_src; s++) {
+            if (g_src[s].dropped)
+                continue;
+            if (g_src[s].sent && !source_delivered(&g_src[s]) &&
+                ((now - g_src[s].fire_ts) <= g_timeout || source_pending(&g_src[s])))
+                continue;
+            source_fire(&g_src[s], now);
+        }
+    }
+
+    /* Let the events in flight land before the counts are compared */
+    while (val_bench_read_counter() < g_end_ts + g_timeout)
+        ;
+    val_bench_sync_range(pe, sizeof(*pe));
+}
+
+static void private_register(void *ignore)
+{
+    uint32_t index = val_pe_get_index();
+
+    if (index >= g_num_pe)
+        return;
+
+    g_pe[index].status = SDEI_TEST_PASS;
+    if (val_sdei_event_register(SIGNAL_EVENT, (uint64_t)asm_event_handler,
+                                (void *)event_handler, 0, 0) ||
+        val_sdei_event_enable(SIGNAL_EVENT))
+        g_pe[index].status = SDEI_TEST_FAIL;
+
+    if (g_ppi_event &&
+        (val_sdei_event_register(g_ppi_event, (uint64_t)asm_event_handler,
+                                 (void *)event_handler, 0, 0) ||
+         val_sdei_event_enable(g_ppi_event)))
+        g_pe[index].status = SDEI_TEST_FAIL;
+
+    val_bench_sync_range(&g_pe[index].status, sizeof(g_pe[index].status));
+}
+
+static void private_unregister(void *ignore)
+{
+    uint32_t index = val_pe_get_index();
+
+    if (index >= g_num_pe)
+        return;
+
+    if (val_sdei_event_unregister(SIGNAL_EVENT))
+        g_pe[index].status = SDEI_TEST_FAIL;
+    if (g_ppi_event && val_sdei_event_unregister(g_ppi_event))
+        g_pe[index].status = SDEI_TEST_FAIL;
+
+    val_bench_sync_range(&g_pe[index].status, sizeof(g_pe[index].status));
+}
+
+/* Puts back the distributor enable state the interrupt had before the test */
+static void source_restore(stress_source_t *src)
+{
+    if (!src->restore)
+        return;
+    if (src->enabled)
+        val_gic_enable_interrupt(src->irq);
+    else
+        val_gic_disable_interrupt(src->irq);
+}
+
+static void source_init(stress_source_t *src, uint32_t kind)
+{
+    src->kind = kind;
+    src->sent = src->received = src->mark = 0;
+    src->dropped = 0;
+    src->fire_ts = 0;
+    g_num_src++;
+}
+
+static uint32_t source_bind(uint32_t irq, uint32_t kind)
+{
+    int32_t err;
+    stress_source_t *src = &g_src[g_num_src];
+
+    src->irq = irq;
+    src->restore = (kind != SRC_PPI) && !val_gic_get_interrupt_enable(irq, &src->enabled);
+
+    err = val_gic_disable_interrupt(irq);
+    if (err) {
+        val_print(ACS_LOG_ERR, "\n        Interrupt %d disable failed", irq);
+        return SDEI_TEST_FAIL;
+    }
+
+    err = val_sdei_interrupt_bind(irq, &src->event);
+    if (err) {
+        val_print(ACS_LOG_ERR, "\n        Interrupt %d bind failed with err %d", irq, err);
+        source_restore(src);
+        return SDEI_TEST_FAIL;
+    }
+
+    source_init(src, kind);
+    return SDEI_TEST_PASS;
+}
+
+/* Fills the shared slots left with SPIs, as test #54 does. The test SPIs come
+ * first. Past them, SPIs enabled in the distributor belong to live devices
+ * and are left alone, and SPIs the dispatcher refuses are skipped. The search
+ * stops when the dispatcher runs out of slots.
+ */
+static uint32_t spi_probe(uint32_t shared_slots)
+{
+    uint32_t irq, num_spi = 0, num_bound = 0;
+    stress_source_t *src;
+    int32_t err;
+
+    val_gic_get_num_spi(&num_spi);
+    for (irq = SPI_INTR_NUM; irq < SPI_BASE + num_spi && num_bound < shared_slots &&
+                             num_bound < STRESS_MAX_SPI; irq++) {
+        src = &g_src[g_num_src];
+        src->irq = irq;
+        if (val_gic_get_interrupt_enable(irq, &src->enabled))
+            continue;
+        if (src->enabled && (irq != SPI_INTR_NUM) && (irq != SPI_INTR_NUM1))
+            continue;
+        if (val_gic_disable_interrupt(irq))
+            continue;
+        src->restore = 1;
+
+        err = val_sdei_interrupt_bind(irq, &src->event);
+        if (err) {
+            source_restore(src);
+            if (err == SDEI_STATUS_OUT_OF_RESOURCE)
+                break;
+            continue;
+        }
+        source_init(src, SRC_SPI);
+        num_bound++;
+    }
+    return num_bound;
+}
+
+/* A shared critical event of the event table is fired through the PAL
+ * trigger, so that critical deliveries preempt the normal ones under load.
+ */
+static void critical_event_add(void)
+{
+    stress_source_t *src = &g_src[g_num_src];
+    uint64_t type = SDEI_EVENT_TYPE_PRIVATE;
+    uint32_t event;
+
+    event = val_event_get(SDEI_EVENT_TYPE_ANY, SDEI_EVENT_PRIORITY_CRITICAL);
+    if (!event)
+        return;
+
+    val_sdei_event_get_info(event, SDEI_EVENT_INFO_EV_TYPE, &type);
+    if (type != SDEI_EVENT_TYPE_SHARED) {
+        val_print(ACS_LOG_INFO, "\n        Critical event %d is private, not fired", event);
+        return;
+    }
+
+    src->event = event;
+    src->irq = SDEI_EVENT_UNBOUND;
+    src->restore = 0;
+    source_init(src, SRC_EVENT);
+}
+
+static uint32_t sources_bind(void)
+{
+    int32_t err;
+    uint64_t num_slots;
+    uint32_t shared_slots, private_slots;
+
+    err = val_sdei_features(BIND_SLOTS_FEATURE, &num_slots);
+    if (err) {
+        val_print(ACS_LOG_ERR, "\n        SDEI_FEATURES failed with err %d", err);
+        return SDEI_TEST_FAIL;
+    }
+    shared_slots = __EXTRACT_BITS(num_slots, 16, 16);
+    private_slots = __EXTRACT_BITS(num_slots, 0, 16);
+
+    /* A non-secure watchdog gives a timer driven source */
+    g_wd_num = val_wd_get_info(0, WD_INFO_COUNT);
+    while (g_wd_num--) {
+        if (!val_wd_get_info(g_wd_num, WD_INFO_ISSECURE))
+            break;
+    }
+    if (g_wd_num >= 0 && shared_slots) {
+        g_wd_addr = val_pa_to_va(val_wd_get_info(g_wd_num, WD_INFO_CTRL_BASE));
+        if (source_bind(val_wd_get_info(g_wd_num, WD_INFO_GSIV), SRC_WD))
+            return SDEI_TEST_FAIL;
+        shared_slots--;
+    }
+
+    if (shared_slots && !spi_probe(shared_slots)) {
+        val_print(ACS_LOG_ERR, "\n        No SPI could be bound");
+        return SDEI_TEST_FAIL;
+    }
+
+    if (private_slots) {
+        g_ppi_src = g_num_src;
+        if (source_bind(PPI_INTR_NUM, SRC_PPI))
+            return SDEI_TEST_FAIL;
+        g_ppi_event = g_src[g_ppi_src].event;
+    }
+
+    critical_event_add();
+
+    val_print(ACS_LOG_INFO, "\n        Firing %d events, %d private", g_num_src, g_ppi_event ? 1 : 0);
+    return SDEI_TEST_PASS;
+}
+
+static uint32_t shared_register(void)
+{
+    uint32_t s, err;
+    uint64_t flags, affinity;
+
+    for (s = 0; s < g_num_src; s++) {
+        if (g_src[s].kind == SRC_PPI)
+            continue;
+
+        /* Alternate between routing to any PE and to a given PE */
+        if (s % 2) {
+            flags = SDEI_EVENT_REGISTER_RM_PE;
+            affinity = val_pe_get_mpid_index(s % g_num_pe);
+        } else {
+            flags = SDEI_EVENT_REGISTER_RM_ANY;
+            affinity = 0;
+        }
+
+        err = val_sdei_event_register(g_src[s].event, (uint64_t)asm_event_handler,
+                                      (void *)event_handler, flags, affinity);
+        if (err) {
+            val_print(ACS_LOG_ERR, "\n        Event %d register failed with err %d",
+                                                                    g_src[s].event, err);
+            return SDEI_TEST_FAIL;
+        }
+        err = val_sdei_event_enable(g_src[s].event);
+        if (err) {
+            val_print(ACS_LOG_ERR, "\n        Event %d enable failed with err %d",
+                                                                    g_src[s].event, err);
+            return SDEI_TEST_FAIL;
+        }
+    }
+    return SDEI_TEST_PASS;
+}
+
+static void shared_unregister(void)
+{
+    uint32_t s;
+
+    for (s = 0; s < g_num_src; s++) {
+        if (g_src[s].kind == SRC_PPI)
+            continue;
+        val_sdei_event_unregister(g_src[s].event);
+    }
+}
+
+static void count_delivery(uint32_t sent, uint32_t received, uint32_t *lost, uint32_t *dup)
+{
+    if (received > sent)
+        *dup += received - sent;
+    else
+        *lost += sent - received;
+}
+
+static uint32_t report(uint64_t elapsed)
+{
+    uint32_t s, index, lost = 0, dup = 0, worst_pe = 0;
+    uint64_t total = 0, priority;
+    bench_stats_t summary;
+
+    for (s = 0; s < g_num_src; s++) {
+        priority = 0;
+        val_sdei_event_get_info(g_src[s].event, SDEI_EVENT_INFO_EV_PRIORITY, &priority);
+        if (g_src[s].kind == SRC_EVENT)
+            val_print(ACS_LOG_INFO, "\n        Platform event %d", g_src[s].event);
+        else
+            val_print(ACS_LOG_INFO, "\n        Interrupt %d event %d", g_src[s].irq, g_src[s].event);
+        val_print(ACS_LOG_INFO, " priority " BENCH_STR_FMT,
+                  (uint64_t)((priority == SDEI_EVENT_PRIORITY_CRITICAL) ? "critical" : "normal"));
+        if (g_src[s].dropped) {
+            val_print(ACS_LOG_INFO, " not fired, no platform trigger");
+            continue;
+        }
+        val_print(ACS_LOG_INFO, " fired %d", g_src[s].sent);
+
+        if (g_src[s].kind == SRC_PPI) {
+            for (index = 0; index < g_num_pe; index++) {
+                count_delivery(g_src[s].sent, g_pe[index].ppi_rx, &lost, &dup);
+                total += g_pe[index].ppi_rx;
+            }
+        } else {
+            val_print(ACS_LOG_INFO, " taken %d", g_src[s].received);
+            count_delivery(g_src[s].sent, g_src[s].received, &lost, &dup);
+            total += g_src[s].received;
+        }
+    }
+
+    for (index = 0; index < g_num_pe; index++) {
+        count_delivery(g_pe[index].sig_sent, g_pe[(index + 1) % g_num_pe].sig_rx, &lost, &dup);
+        total += g_pe[index].sig_rx;
+    }
+
+    val_print(ACS_LOG_TEST, "\n        Events delivered   : %lld", total);
+    val_print(ACS_LOG_TEST, "\n        Events per second  : %lld",
+              (total * 1000000000ULL) / (val_bench_ticks_to_ns(elapsed) ?
+                                         val_bench_ticks_to_ns(elapsed) : 1));
+    val_print(ACS_LOG_TEST, "\n        Lost %d, duplicated %d", lost, dup);
+
+    summary.count = 0;
+    for (index = 0; index < g_num_pe; index++) {
+        val_bench_get_stats(g_pe[index].lat, (g_pe[index].lat_count < BENCH_MAX_SAMPLES) ?
+                            g_pe[index].lat_count : BENCH_MAX_SAMPLES, &g_stats[index]);
+        val_bench_merge_stats(&summary, &g_stats[index]);
+        if (g_stats[index].median > g_stats[worst_pe].median)
+            worst_pe = index;
+    }
+    val_bench_report(ACS_LOG_TEST, "Handler latency under load:", &summary);
+    val_print(ACS_LOG_TEST, " slowest PE %d", worst_pe);
+    for (index = 0; index < g_num_pe; index++) {
+        val_print(ACS_LOG_DEBUG, "\n          PE %d", index);
+        val_bench_report(ACS_LOG_DEBUG, "  latency :", &g_stats[index]);
+    }
+
+    if (lost || dup) {
+        val_print(ACS_LOG_ERR, "\n        Events lost or duplicated under load");
+        return SDEI_TEST_FAIL;
+    }
+    return SDEI_TEST_PASS;
+}
+
+static void test_entry(void)
+{
+    uint32_t s, index, status;
+    uint64_t start;
+
+    g_num_pe = val_pe_get_num();
+    if (g_num_pe > BENCH_MAX_PE) {
+        val_print(ACS_LOG_WARN, "\n        Stressing the first %d PEs only", BENCH_MAX_PE);
+        g_num_pe = BENCH_MAX_PE;
+    }
+    g_driver_pe = val_pe_get_index();
+    g_num_src = 0;
+    g_ppi_event = 0;
+    g_wd_addr = NULL;
+    g_timeout = val_bench_us_to_ticks(STRESS_EVENT_TIMEOUT_US);
+
+    for (index = 0; index < g_num_pe; index++) {
+        g_pe[index].sig_sent = g_pe[index].sig_rx = g_pe[index].ppi_rx = 0;
+        g_pe[index].lat_count = g_pe[index].sig_mark = 0;
+        g_pe[index].sig_ts = 0;
+        g_pe[index].target_mpid = val_pe_get_mpid_index((index + 1) % g_num_pe);
+        g_pe[index].status = SDEI_TEST_PENDING;
+    }
+
+    status = sources_bind();
+    if (status != SDEI_TEST_PASS)
+        goto event_release;
+
+    val_bench_sync_range(g_pe, sizeof(g_pe));
+    val_bench_sync_range(g_src, sizeof(g_src));
+    val_bench_sync_range(&g_num_src, sizeof(g_num_src));
+    val_bench_sync_range(&g_ppi_event, sizeof(g_ppi_event));
+    val_bench_sync_range(&g_num_pe, sizeof(g_num_pe));
+    val_bench_sync_range(&g_wd_num, sizeof(g_wd_num));
+    val_bench_sync_range(&g_wd_addr, sizeof(g_wd_addr));
+    val_bench_sync_range(&g_timeout, sizeof(g_timeout));
+    val_bench_sync_range(&g_driver_pe, sizeof(g_driver_pe));
+
+    val_pe_execute_on_all((void *)private_register, 0);
+    for (index = 0; index < g_num_pe; index++) {
+        if (g_pe[index].status != SDEI_TEST_PASS) {
+            val_print(ACS_LOG_ERR, "\n        Private event register failed on PE %d", index);
+            status = SDEI_TEST_FAIL;
+        }
+    }
+    if (status == SDEI_TEST_PASS)
+        status = shared_register();
+
+    if (status == SDEI_TEST_PASS) {
+        start = val_bench_read_counter();
+        g_end_ts = start + val_bench_us_to_ticks(STRESS_DURATION_US);
+        val_bench_sync_range(&g_end_ts, sizeof(g_end_ts));
+
+        val_pe_execute_on_all_concurrent((void *)payload, 0);
+
+        val_bench_sync_range(g_pe, sizeof(g_pe));
+        val_bench_sync_range(g_src, sizeof(g_src));
+        for (index = 0; index < g_num_pe; index++) {
+            if (g_pe[index].status != SDEI_TEST_PASS) {
+                val_print(ACS_LOG_ERR, "\n        Event signal failed on PE %d", index);
+                status = SDEI_TEST_FAIL;
+            }
+        }
+        if (report(g_end_ts - start) != SDEI_TEST_PASS)
+            status = SDEI_TEST_FAIL;
+    }
+
+    if (g_wd_addr)
+        val_wd_set_ws0(g_wd_addr, g_wd_num, 0);
+    shared_unregister();
+    val_pe_execute_on_all((void *)private_unregister, 0);
+
+event_release:
+    for (s = 0; s < g_num_src; s++) {
+        if (g_src[s].kind == SRC_EVENT)
+            continue;
+        if (val_sdei_interrupt_release(g_src[s].event))
+            val_print(ACS_LOG_ERR, "\n        Event number %d release failed", g_src[s].event);
+        source_restore(&g_src[s]);
+    }
+    if (g_wd_addr)
+        val_va_free(g_wd_addr);
+
+    val_test_pe_set_status(val_pe_get_index(), status);
+}
+
+SDEI_SET_TEST_DEPS(test_052_deps, TEST_001_ID, TEST_002_ID, TEST_004_ID);
+SDEI_PUBLISH_TEST(test_052, TEST_052_ID, TEST_DESC, test_052_deps, test_entry, FALSE);
@@ -0,0 +1,493 @@
+/** @file
+ * Copyright (c) 2018, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+**/
+
+#include <val_interface.h>
+#include <val_sdei_interface.h>
+#include <val_benchmark.h>
+
+#define TEST_DESC "Measure critical event preemption latency      "
+
+#define BENCH_ITER          64
+#define BENCH_HOLD_US       100
+#define OUTLIER_FACTOR      10
+#define SIGNAL_EVENT        0
+#define EVENT_NONE          0xFFFFFFFF
+#define SPI_BASE            32
+#define PROBE_MAX           16
+
+/* Event raised from inside a running normal priority handler */
+typedef enum {
+    MODE_CRITICAL = 0,  /* critical platform event, preempts the handler */
+    MODE_NORMAL,        /* normal bound SPI, held until the handler completes */
+    MODE_MAX
+} bench_mode_t;
+
+typedef enum {
+    METRIC_ENTRY = 0,
+    METRIC_HANDLER,
+    METRIC_RESUME,
+    METRIC_STALL,
+    METRIC_MAX
+} bench_metric_t;
+
+static char *g_mode_name[MODE_MAX] = {
+    "Critical event in normal handler",
+    "Normal event in normal handler  "
+};
+
+static char *g_metric_name[MODE_MAX][METRIC_MAX] = {
+    {
+        "  trigger to critical entry    :",
+        "  critical handler             :",
+        "  critical exit to resumption  :",
+        "  normal handler stall         :"
+    },
+    {
+        "  trigger to deferred entry    :",
+        "  deferred handler             :",
+        "  normal completion to entry   :",
+        NULL
+    }
+};
+
+static uint64_t g_samples[METRIC_MAX][BENCH_ITER];
+static bench_stats_t g_stats[BENCH_MAX_PE][MODE_MAX][METRIC_MAX];
+static uint32_t g_outliers[BENCH_MAX_PE][MODE_MAX][METRIC_MAX];
+static uint32_t g_measured[BENCH_MAX_PE][MODE_MAX];
+static uint32_t g_pe_status[BENCH_MAX_PE];
+static uint32_t g_event[MODE_MAX];
+static uint32_t g_critical_private;
+static uint32_t g_critical_irq;
+static uint32_t g_critical_enabled;
+static uint32_t g_probe_irq[PROBE_MAX];
+static uint32_t g_probe_event[PROBE_MAX];
+static uint32_t g_probe_enabled[PROBE_MAX];
+static uint32_t g_target_pe;
+static uint32_t g_num_pe;
+static uint32_t g_mode;
+static uint64_t g_hold_ticks;
+
+/* Timeline of one iteration */
+static volatile uint64_t g_trigger_ts;
+static volatile uint64_t g_inner_entry_ts;
+static volatile uint64_t g_inner_exit_ts;
+static volatile uint64_t g_outer_complete_ts;
+static volatile uint64_t g_resume_ts;
+static volatile uint32_t g_outer_done;
+static volatile uint32_t g_error;
+static volatile int32_t g_trigger_err;
+
+static void inner_handler(uint64_t entry_ts)
+{
+    g_inner_entry_ts = entry_ts;
+    /* The outer trampoline stamped its completion before this event was taken */
+    if (g_mode == MODE_NORMAL)
+        g_outer_complete_ts = g_bench_complete_ts;
+}
+
+static void outer_handler(uint64_t entry_ts)
+{
+    uint64_t timeout = TIMEOUT_MEDIUM, end;
+
+    g_trigger_ts = val_bench_read_counter();
+    if (g_mode == MODE_CRITICAL) {
+        g_trigger_err = val_sdei_event_trigger(g_event[MODE_CRITICAL]);
+        if (g_trigger_err) {
+            g_error = 1;
+            goto done;
+        }
+        /* The critical handler runs on top of this loop */
+        while (!g_bench_complete_ts && timeout--)
+            ;
+        g_resume_ts = val_bench_read_counter();
+        g_inner_exit_ts = g_bench_complete_ts;
+        if (!g_inner_exit_ts)
+            g_error = 1;
+    } else {
+        if (val_gic_generate_interrupt(SPI_INTR_NUM)) {
+            g_error = 1;
+            goto done;
+        }
+        /* An event of the same priority must wait for this handler */
+        end = g_trigger_ts + g_hold_ticks;
+        while (val_bench_read_counter() < end)
+            ;
+        if (g_inner_entry_ts)
+            g_error = 1;
+    }
+done:
+    g_outer_done = 1;
+}
+
+static uint32_t count_outliers(uint64_t *samples, uint32_t count, bench_stats_t *stats)
+{
+    uint32_t i, outliers = 0;
+
+    for (i = 0; i < count; i++)
+        if (stats->median && samples[i] > stats->median * OUTLIER_FACTOR)
+            outliers++;
+    return outliers;
+}
+
+static uint32_t run_iteration(uint64_t affinity, uint32_t iter)
+{
+    uint64_t timeout = TIMEOUT_MEDIUM;
+
+    g_trigger_ts = g_inner_entry_ts = g_inner_exit_ts = 0;
+    g_outer_complete_ts = g_resume_ts = 0;
+    g_outer_done = g_error = 0;
+    g_trigger_err = 0;
+    g_bench_complete_ts = 0;
+
+    if (val_sdei_event_signal(SIGNAL_EVENT, affinity))
+        return SDEI_TEST_FAIL;
+
+    /* Both handlers have run once the inner one has completed */
+    while (timeout--) {
+        if (g_outer_done && g_inner_entry_ts && g_bench_complete_ts &&
+            (g_mode == MODE_CRITICAL || g_bench_complete_ts != g_outer_complete_ts))
+            break;
+    }
+    /* No platform hook to raise the critical event */
+    if (g_outer_done && g_trigger_err == SDEI_STATUS_NOT_SUPPORTED)
+        return SDEI_TEST_SKIP;
+    if (!g_outer_done || !g_inner_entry_ts || g_error)
+        return SDEI_TEST_FAIL;
+
+    if (g_mode == MODE_CRITICAL) {
+        g_samples[METRIC_ENTRY][iter] = g_inner_entry_ts - g_trigger_ts;
+        g_samples[METRIC_HANDLER][iter] = g_inner_exit_ts - g_inner_entry_ts;
+        g_samples[METRIC_RESUME][iter] = g_resume_ts - g_inner_exit_ts;
+        g_samples[METRIC_STALL][iter] = g_resume_ts - g_trigger_ts;
+    } else {
+        g_samples[METRIC_ENTRY][iter] = g_inner_entry_ts - g_trigger_ts;
+        g_samples[METRIC_HANDLER][iter] = g_bench_complete_ts - g_inner_entry_ts;
+        g_samples[METRIC_RESUME][iter] = g_inner_entry_ts - g_outer_complete_ts;
+    }
+    return SDEI_TEST_PASS;
+}
+
+/* Takes BENCH_ITER nested events of one mode on the current PE. Nothing is
+ * printed here, secondary PEs run with a small stack.
+ */
+static uint32_t measure_mode(uint32_t index, uint32_t mode)
+{
+    uint32_t iter, metric, status = SDEI_TEST_PASS;
+    uint32_t event = g_event[mode];
+    uint64_t affinity = val_pe_get_mpid_index(index);
+    uint64_t flags = SDEI_EVENT_REGISTER_RM_PE;
+
+    if (event == EVENT_NONE)
+        return SDEI_TEST_PASS;
+
+    g_mode = mode;
+    if (mode == MODE_CRITICAL && g_critical_private)
+        flags = SDEI_EVENT_REGISTER_RM_ANY;
+
+    if (val_sdei_event_register(SIGNAL_EVENT, (uint64_t)asm_event_handler_timed,
+                                (void *)outer_handler, 0, 0))
+        return SDEI_TEST_FAIL;
+    if (val_sdei_event_register(event, (uint64_t)asm_event_handler_timed,
+                                (void *)inner_handler, flags, affinity)) {
+        status = SDEI_TEST_FAIL;
+        goto outer_unregister;
+    }
+    if (val_sdei_event_enable(SIGNAL_EVENT) || val_sdei_event_enable(event)) {
+        status = SDEI_TEST_FAIL;
+        goto inner_unregister;
+    }
+
+    for (iter = 0; iter < BENCH_ITER; iter++) {
+        status = run_iteration(affinity, iter);
+        if (status == SDEI_TEST_SKIP) {
+            status = SDEI_TEST_PASS;
+            goto inner_unregister;
+        }
+        if (status != SDEI_TEST_PASS)
+            goto inner_unregister;
+    }
+    g_measured[index][mode] = 1;
+
+    for (metric = 0; metric < METRIC_MAX; metric++) {
+        if (!g_metric_name[mode][metric])
+            continue;
+        val_bench_get_stats(g_samples[metric], BENCH_ITER, &g_stats[index][mode][metric]);
+        g_outliers[index][mode][metric] = count_outliers(g_samples[metric], BENCH_ITER,
+                                                         &g_stats[index][mode][metric]);
+    }
+
+inner_unregister:
+    if (val_sdei_event_unregister(event))
+        status = SDEI_TEST_FAIL;
+outer_unregister:
+    if (val_sdei_event_unregister(SIGNAL_EVENT))
+        status = SDEI_TEST_FAIL;
+    return status;
+}
+
+static void payload(void *ignore)
+{
+    uint32_t mode, index = val_pe_get_index();
+
+    /* Events are taken by one PE at a time, the rest of the system idle */
+    if ((index >= g_num_pe) || (index != g_target_pe))
+        return;
+
+    for (mode = 0; mode < MODE_MAX; mode++) {
+        g_measured[index][mode] = 0;
+        g_pe_status[index] = measure_mode(index, mode);
+        if (g_pe_status[index] != SDEI_TEST_PASS)
+            break;
+    }
+
+    val_bench_sync_range(g_stats[index], sizeof(g_stats[index]));
+    val_bench_sync_range(g_outliers[index], sizeof(g_outliers[index]));
+    val_bench_sync_range(g_measured[index], sizeof(g_measured[index]));
+    val_bench_sync_range(&g_pe_status[index], sizeof(g_pe_status[index]));
+}
+
+/* Puts back the distributor enable state an SPI had before it was probed */
+static void irq_restore(uint32_t irq, uint32_t enabled)
+{
+    if (enabled)
+        val_gic_enable_interrupt(irq);
+    else
+        val_gic_disable_interrupt(irq);
+}
+
+/* A dispatcher may back some of its bind slots with critical events. An event
+ * bound that way is raised by pending its interrupt. SPIs are bound as in
+ * test #54 until one gives a critical event or the slots run out, then the
+ * others are released.
+ */
+static uint32_t critical_event_bind(void)
+{
+    uint32_t i, irq, enabled, event, num_spi = 0, num_probe = 0, found = EVENT_NONE;
+    uint64_t priority;
+    int32_t err;
+
+    val_gic_get_num_spi(&num_spi);
+    for (irq = SPI_INTR_NUM1; irq < SPI_BASE + num_spi && num_probe < PROBE_MAX; irq++) {
+        if (val_gic_get_interrupt_enable(irq, &enabled))
+            continue;
+        if (enabled && (irq != SPI_INTR_NUM1))
+            continue;
+        if (val_gic_disable_interrupt(irq))
+            continue;
+        err = val_sdei_interrupt_bind(irq, &event);
+        if (err) {
+            irq_restore(irq, enabled);
+            if (err == SDEI_STATUS_OUT_OF_RESOURCE)
+                break;
+            continue;
+        }
+
+        priority = 0;
+        val_sdei_event_get_info(event, SDEI_EVENT_INFO_EV_PRIORITY, &priority);
+        if (priority == SDEI_EVENT_PRIORITY_CRITICAL) {
+            g_critical_irq = irq;
+            g_critical_enabled = enabled;
+            found = event;
+            break;
+        }
+        g_probe_irq[num_probe] = irq;
+        g_probe_event[num_probe] = event;
+        g_probe_enabled[num_probe++] = enabled;
+    }
+
+    for (i = 0; i < num_probe; i++) {
+        if (val_sdei_interrupt_release(g_probe_event[i]))
+            val_print(ACS_LOG_ERR, "\n        Event number %d release failed", g_probe_event[i]);
+        irq_restore(g_probe_irq[i], g_probe_enabled[i]);
+    }
+    return found;
+}
+
+static uint32_t critical_event_find(void)
+{
+    uint64_t type = 0;
+    uint32_t event;
+
+    event = critical_event_bind();
+    if (event != EVENT_NONE) {
+        val_print(ACS_LOG_INFO, "\n        Critical event %d bound to interrupt %d",
+                                                            event, g_critical_irq);
+        return event;
+    }
+
+    /* A platform event can only be raised through the PAL trigger */
+    event = val_event_get(SDEI_EVENT_TYPE_ANY, SDEI_EVENT_PRIORITY_CRITICAL);
+    if (!event) {
+        val_print(ACS_LOG_WARN, "\n        No critical priority event, preemption not measured");
+        return EVENT_NONE;
+    }
+
+    val_sdei_event_get_info(event, SDEI_EVENT_INFO_EV_TYPE, &type);
+    g_critical_private = (type == SDEI_EVENT_TYPE_PRIVATE);
+    return event;
+}
+
+static uint32_t spi_event_bind(void)
+{
+    int32_t err;
+
+    err = val_gic_disable_interrupt(SPI_INTR_NUM);
+    if (err) {
+        val_print(ACS_LOG_ERR, "\n        Interrupt %d disable failed", SPI_INTR_NUM);
+        return SDEI_TEST_FAIL;
+    }
+
+    err = val_sdei_interrupt_bind(SPI_INTR_NUM, &g_event[MODE_NORMAL]);
+    if (err) {
+        val_print(ACS_LOG_ERR, "\n        SPI intr number %d bind failed with err %d",
+                                                                    SPI_INTR_NUM, err);
+        g_event[MODE_NORMAL] = EVENT_NONE;
+        return SDEI_TEST_FAIL;
+    }
+
+    return SDEI_TEST_PASS;
+}
+
+static void report(void)
+{
+    uint32_t mode, metric, index, worst_pe, outliers, measured;
+    bench_stats_t summary;
+
+    for (mode = 0; mode < MODE_MAX; mode++) {
+        if (g_event[mode] == EVENT_NONE)
+            continue;
+
+        measured = 0;
+        for (index = 0; index < g_num_pe; index++)
+            measured += g_measured[index][mode];
+        if (!measured) {
+            val_print(ACS_LOG_WARN, "\n        Event %d cannot be raised on this platform,",
+                                                                            g_event[mode]);
+            val_print(ACS_LOG_WARN, " " BENCH_STR_FMT " not measured",
+                                                            (uint64_t)g_mode_name[mode]);
+            continue;
+        }
+
+        val_print(ACS_LOG_TEST, "\n        " BENCH_STR_FMT, (uint64_t)g_mode_name[mode]);
+        val_print(ACS_LOG_TEST, " event %d", g_event[mode]);
+
+        for (metric = 0; metric < METRIC_MAX; metric++) {
+            if (!g_metric_name[mode][metric])
+                continue;
+            summary.count = 0;
+            worst_pe = 0;
+            outliers = 0;
+            for (index = 0; index < g_num_pe; index++) {
+                if (!g_measured[index][mode])
+                    continue;
+                val_bench_merge_stats(&summary, &g_stats[index][mode][metric]);
+                outliers += g_outliers[index][mode][metric];
+                if (g_stats[index][mode][metric].median > g_stats[worst_pe][mode][metric].median)
+                    worst_pe = index;
+            }
+            val_bench_report(ACS_LOG_TEST, g_metric_name[mode][metric], &summary);
+            val_print(ACS_LOG_TEST, " slowest PE %d", worst_pe);
+
+            for (index = 0; index < g_num_pe; index++) {
+                if (!g_measured[index][mode])
+                    continue;
+                val_print(ACS_LOG_DEBUG, "\n          PE %d", index);
+                val_bench_report(ACS_LOG_DEBUG, g_metric_name[mode][metric],
+                                 &g_stats[index][mode][metric]);
+                if (g_outliers[index][mode][metric])
+                    val_print(ACS_LOG_WARN, "\n          PE %d: %d samples over %dx the median",
+                              index, g_outliers[index][mode][metric], OUTLIER_FACTOR);
+            }
+            if (outliers)
+                val_print(ACS_LOG_WARN, "\n        %d outliers over %dx the median",
+                                                                outliers, OUTLIER_FACTOR);
+        }
+    }
+}
+
+static void test_entry(void)
+{
+    uint32_t index, status, measured = 0;
+
+    g_num_pe = val_pe_get_num();
+    if (g_num_pe > BENCH_MAX_PE) {
+        val_print(ACS_LOG_WARN, "\n        Measuring the first %d PEs only", BENCH_MAX_PE);
+        g_num_pe = BENCH_MAX_PE;
+    }
+    g_hold_ticks = val_bench_us_to_ticks(BENCH_HOLD_US);
+    g_critical_private = 0;
+    g_critical_irq = 0;
+
+    /* The normal SPI is bound first, the critical search skips it */
+    g_event[MODE_CRITICAL] = EVENT_NONE;
+    g_event[MODE_NORMAL] = EVENT_NONE;
+    status = spi_event_bind();
+    if (status != SDEI_TEST_PASS)
+        goto event_release;
+    g_event[MODE_CRITICAL] = critical_event_find();
+
+    for (index = 0; index < g_num_pe; index++)
+        g_pe_status[index] = SDEI_TEST_PENDING;
+    val_bench_sync_range(g_pe_status, sizeof(g_pe_status));
+    val_bench_sync_range(g_event, sizeof(g_event));
+    val_bench_sync_range(&g_critical_private, sizeof(g_critical_private));
+    val_bench_sync_range(&g_num_pe, sizeof(g_num_pe));
+    val_bench_sync_range(&g_hold_ticks, sizeof(g_hold_ticks));
+
+    for (g_target_pe = 0; g_target_pe < g_num_pe; g_target_pe++) {
+        val_bench_sync_range(&g_target_pe, sizeof(g_target_pe));
+        val_pe_execute_on_all((void *)payload, 0);
+    }
+
+    val_bench_sync_range(g_stats, sizeof(g_stats));
+    val_bench_sync_range(g_outliers, sizeof(g_outliers));
+    val_bench_sync_range(g_measured, sizeof(g_measured));
+    val_bench_sync_range(g_pe_status, sizeof(g_pe_status));
+    for (index = 0; index < g_num_pe; index++) {
+        if (g_pe_status[index] != SDEI_TEST_PASS) {
+            val_print(ACS_LOG_ERR, "\n        Nested event delivery failed on PE %d", index);
+            status = SDEI_TEST_FAIL;
+        }
+    }
+
+    if (status == SDEI_TEST_PASS)
+        report();
+
+    /* Without a critical event taken the preemption latency is not measured */
+    for (index = 0; index < g_num_pe; index++)
+        measured += g_measured[index][MODE_CRITICAL];
+    if (status == SDEI_TEST_PASS && !measured) {
+        val_print(ACS_LOG_WARN, "\n        Critical event preemption not measured");
+        status = SDEI_TEST_SKIP;
+    }
+
+event_release:
+    if (g_event[MODE_NORMAL] != EVENT_NONE &&
+        val_sdei_interrupt_release(g_event[MODE_NORMAL]))
+        val_print(ACS_LOG_ERR, "\n        Event number %d release failed", g_event[MODE_NORMAL]);
+    if (g_critical_irq) {
+        if (val_sdei_interrupt_release(g_event[MODE_CRITICAL]))
+            val_print(ACS_LOG_ERR, "\n        Event number %d release failed",
+                                                            g_event[MODE_CRITICAL]);
+        irq_restore(g_critical_irq, g_critical_enabled);
+    }
+
+    val_test_pe_set_status(val_pe_get_index(), status);
+}
+
+SDEI_SET_TEST_DEPS(test_053_deps, TEST_001_ID, TEST_002_ID, TEST_041_ID);
+SDEI_PUBLISH_TEST(test_053, TEST_053_ID, TEST_DESC, test_053_deps, test_entry, FALSE);
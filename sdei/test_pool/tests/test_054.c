@@ -0,0 +1,326 @@
+/** @file
+ * Copyright (c) 2018, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+**/
+
+#include <val_interface.h>
+#include <val_sdei_interface.h>
+#include <val_benchmark.h>
+
+#define TEST_DESC "Measure interrupt bind and release scaling     "
+
+#define BIND_SLOTS_FEATURE  0
+#define BIND_MAX            BENCH_MAX_SAMPLES
+#define BIND_REPEAT         3
+#define BIND_BUCKETS        8
+#define SPI_BASE            32
+/* Cost growth from the emptiest to the fullest bucket reported as super-linear */
+#define SCALING_LIMIT       2
+
+typedef enum {
+    ORDER_FIFO = 0,     /* first bound, first released */
+    ORDER_LIFO,         /* last bound, first released */
+    ORDER_INTERLEAVED,  /* even bind slots, then odd ones */
+    ORDER_MAX
+} release_order_t;
+
+typedef enum {
+    OP_BIND = 0,
+    OP_RELEASE,
+    OP_MAX
+} bench_op_t;
+
+#define BIND_ROUNDS         (ORDER_MAX * BIND_REPEAT)
+
+static char *g_order_name[ORDER_MAX] = {
+    "Release, first bound first     :",
+    "Release, last bound first      :",
+    "Release, interleaved           :"
+};
+
+static char *g_op_name[OP_MAX] = {
+    "Bind                           :",
+    "Release                        :"
+};
+
+static uint32_t g_irq[BIND_MAX];
+static uint32_t g_event[BIND_MAX];
+static uint32_t g_bound[BIND_MAX];
+static uint32_t g_enabled[BIND_MAX];
+static uint32_t g_num_irq;
+
+/* Latency of an operation by the number of interrupts bound before it */
+static uint64_t g_lat[OP_MAX][BIND_MAX][BIND_ROUNDS];
+static uint64_t g_order_lat[ORDER_MAX][BIND_MAX * BIND_REPEAT];
+static uint32_t g_order_count[ORDER_MAX];
+static uint64_t g_median[OP_MAX][BIND_MAX];
+
+static uint32_t release_index(uint32_t order, uint32_t i)
+{
+    uint32_t half = (g_num_irq + 1) / 2;
+
+    switch (order) {
+    case ORDER_LIFO:
+        return g_num_irq - 1 - i;
+    case ORDER_INTERLEAVED:
+        return (i < half) ? (2 * i) : (2 * (i - half) + 1);
+    default:
+        return i;
+    }
+}
+
+static uint32_t release_all(void)
+{
+    uint32_t i, status = SDEI_TEST_PASS;
+
+    for (i = 0; i < g_num_irq; i++) {
+        if (!g_bound[i])
+            continue;
+        if (val_sdei_interrupt_release(g_event[i])) {
+            val_print(ACS_LOG_ERR, "\n        Event number %d release failed", g_event[i]);
+            status = SDEI_TEST_FAIL;
+        }
+        g_bound[i] = 0;
+    }
+    return status;
+}
+
+/* Puts back the distributor enable state an SPI had before it was probed */
+static void irq_restore(uint32_t irq, uint32_t enabled)
+{
+    if (enabled)
+        val_gic_enable_interrupt(irq);
+    else
+        val_gic_disable_interrupt(irq);
+}
+
+static void restore_all(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < g_num_irq; i++)
+        irq_restore(g_irq[i], g_enabled[i]);
+}
+
+/* Finds the SPIs that can be bound, up to the shared slot limit. The search
+ * starts at the SPIs used by the other tests. Past them, SPIs already enabled
+ * in the distributor belong to live devices and are left alone, and SPIs
+ * that the dispatcher refuses, such as those owned by the secure world, are
+ * skipped.
+ */
+static uint32_t irq_probe(uint32_t max_irq, uint32_t max_bound)
+{
+    uint32_t irq, enabled;
+    int32_t err;
+
+    if (max_bound > BIND_MAX)
+        max_bound = BIND_MAX;
+
+    for (irq = SPI_INTR_NUM; irq < max_irq && g_num_irq < max_bound; irq++) {
+        if (val_gic_get_interrupt_enable(irq, &enabled))
+            continue;
+        if (enabled && (irq != SPI_INTR_NUM) && (irq != SPI_INTR_NUM1))
+            continue;
+        if (val_gic_disable_interrupt(irq))
+            continue;
+        err = val_sdei_interrupt_bind(irq, &g_event[g_num_irq]);
+        if (err) {
+            irq_restore(irq, enabled);
+            if (err == SDEI_STATUS_OUT_OF_RESOURCE)
+                break;
+            continue;
+        }
+        g_irq[g_num_irq] = irq;
+        g_enabled[g_num_irq] = enabled;
+        g_bound[g_num_irq++] = 1;
+    }
+
+    return release_all();
+}
+
+static uint32_t run_round(uint32_t round)
+{
+    uint32_t i, slot, order = round % ORDER_MAX;
+    uint64_t start, lat;
+    int32_t err;
+
+    for (i = 0; i < g_num_irq; i++) {
+        start = val_bench_read_counter();
+        err = val_sdei_interrupt_bind(g_irq[i], &g_event[i]);
+        lat = val_bench_read_counter() - start;
+        if (err) {
+            val_print(ACS_LOG_ERR, "\n        Interrupt %d bind failed with err %d", g_irq[i], err);
+            return SDEI_TEST_FAIL;
+        }
+        g_bound[i] = 1;
+        g_lat[OP_BIND][i][round] = lat;
+    }
+
+    for (i = 0; i < g_num_irq; i++) {
+        slot = release_index(order, i);
+        start = val_bench_read_counter();
+        err = val_sdei_interrupt_release(g_event[slot]);
+        lat = val_bench_read_counter() - start;
+        if (err) {
+            val_print(ACS_LOG_ERR, "\n        Event number %d release failed with err %d",
+                                                                        g_event[slot], err);
+            return SDEI_TEST_FAIL;
+        }
+        g_bound[slot] = 0;
+        /* Indexed by the interrupts still bound besides this one */
+        g_lat[OP_RELEASE][g_num_irq - 1 - i][round] = lat;
+        g_order_lat[order][g_order_count[order]++] = lat;
+    }
+
+    return SDEI_TEST_PASS;
+}
+
+/* Least squares slope of the median cost against occupancy, in ns per bound
+ * interrupt. A flat curve is constant time bookkeeping, a rising one grows
+ * the total cost of binding n interrupts faster than n.
+ */
+static int64_t cost_slope(uint64_t *median)
+{
+    int64_t n = g_num_irq, sx = 0, sy = 0, sxx = 0, sxy = 0, x, y, den;
+
+    for (x = 0; x < n; x++) {
+        y = val_bench_ticks_to_ns(median[x]);
+        sx += x;
+        sy += y;
+        sxx += x * x;
+        sxy += x * y;
+    }
+    den = n * sxx - sx * sx;
+    return den ? (n * sxy - sx * sy) / den : 0;
+}
+
+static uint64_t bucket_median(uint64_t *median, uint32_t first, uint32_t last)
+{
+    uint64_t samples[BIND_MAX];
+    bench_stats_t stats;
+    uint32_t i;
+
+    for (i = first; i <= last; i++)
+        samples[i - first] = median[i];
+    val_bench_get_stats(samples, last - first + 1, &stats);
+    return stats.median;
+}
+
+static void report(void)
+{
+    uint32_t op, order, n, b, buckets, first, last;
+    uint64_t low, high, cost;
+    bench_stats_t stats, summary;
+
+    for (op = 0; op < OP_MAX; op++) {
+        summary.count = 0;
+        for (n = 0; n < g_num_irq; n++) {
+            val_bench_get_stats(g_lat[op][n], BIND_ROUNDS, &stats);
+            g_median[op][n] = stats.median;
+            val_bench_merge_stats(&summary, &stats);
+        }
+        val_bench_report(ACS_LOG_TEST, g_op_name[op], &summary);
+    }
+
+    for (order = 0; order < ORDER_MAX; order++) {
+        val_bench_get_stats(g_order_lat[order], g_order_count[order], &stats);
+        val_bench_report(ACS_LOG_TEST, g_order_name[order], &stats);
+    }
+
+    /* Median cost by occupancy, in buckets of bound interrupts */
+    buckets = (g_num_irq < BIND_BUCKETS) ? g_num_irq : BIND_BUCKETS;
+    val_print(ACS_LOG_TEST, "\n        Median cost by interrupts already bound (ns)");
+    for (b = 0; b < buckets; b++) {
+        first = (b * g_num_irq) / buckets;
+        last = ((b + 1) * g_num_irq) / buckets - 1;
+        val_print(ACS_LOG_TEST, "\n          %3d to %3d", first, last);
+        val_print(ACS_LOG_TEST, " : bind %6lld",
+                  val_bench_ticks_to_ns(bucket_median(g_median[OP_BIND], first, last)));
+        val_print(ACS_LOG_TEST, " release %6lld",
+                  val_bench_ticks_to_ns(bucket_median(g_median[OP_RELEASE], first, last)));
+    }
+
+    for (n = 0; n < g_num_irq; n++) {
+        val_print(ACS_LOG_DEBUG, "\n          %3d bound : bind %lld", n,
+                  val_bench_ticks_to_ns(g_median[OP_BIND][n]));
+        val_print(ACS_LOG_DEBUG, " release %lld ns", val_bench_ticks_to_ns(g_median[OP_RELEASE][n]));
+    }
+
+    for (op = 0; op < OP_MAX; op++) {
+        val_print(ACS_LOG_TEST, "\n        " BENCH_STR_FMT, (uint64_t)g_op_name[op]);
+        val_print(ACS_LOG_TEST, " slope %lld ns per bound interrupt", cost_slope(g_median[op]));
+
+        if (buckets < 2)
+            continue;
+        low = bucket_median(g_median[op], 0, g_num_irq / buckets - 1);
+        high = bucket_median(g_median[op], ((buckets - 1) * g_num_irq) / buckets, g_num_irq - 1);
+        if (high > low * SCALING_LIMIT) {
+            cost = low ? (high * 100) / low : 0;
+            val_print(ACS_LOG_WARN, "\n        " BENCH_STR_FMT, (uint64_t)g_op_name[op]);
+            val_print(ACS_LOG_WARN, " cost grows to %lld%% when full, super-linear total", cost);
+        }
+    }
+}
+
+static void test_entry(void)
+{
+    uint32_t round, order, num_spi = 0, shared_slots, status;
+    uint64_t num_slots;
+    int32_t err;
+
+    err = val_sdei_features(BIND_SLOTS_FEATURE, &num_slots);
+    if (err) {
+        val_print(ACS_LOG_ERR, "\n        SDEI_FEATURES failed with err %d", err);
+        val_test_pe_set_status(val_pe_get_index(), SDEI_TEST_FAIL);
+        return;
+    }
+    shared_slots = __EXTRACT_BITS(num_slots, 16, 16);
+
+    val_gic_get_num_spi(&num_spi);
+    g_num_irq = 0;
+    status = irq_probe(SPI_BASE + num_spi, shared_slots);
+    if (status != SDEI_TEST_PASS)
+        goto test_end;
+
+    val_print(ACS_LOG_TEST, "\n        %d SPIs bound of %d shared slots", g_num_irq, shared_slots);
+    val_print(ACS_LOG_TEST, ", GIC implements %d SPIs", num_spi);
+    if (g_num_irq < 2) {
+        val_print(ACS_LOG_WARN, "\n        Too few interrupts can be bound to measure scaling");
+        status = SDEI_TEST_SKIP;
+        goto test_end;
+    }
+
+    for (order = 0; order < ORDER_MAX; order++)
+        g_order_count[order] = 0;
+
+    for (round = 0; round < BIND_ROUNDS; round++) {
+        status = run_round(round);
+        if (status != SDEI_TEST_PASS)
+            break;
+    }
+
+    if (release_all() != SDEI_TEST_PASS)
+        status = SDEI_TEST_FAIL;
+
+    if (status == SDEI_TEST_PASS)
+        report();
+
+test_end:
+    restore_all();
+    val_test_pe_set_status(val_pe_get_index(), status);
+}
+
+SDEI_SET_TEST_DEPS(test_054_deps, TEST_001_ID, TEST_002_ID);
+SDEI_PUBLISH_TEST(test_054, TEST_054_ID, TEST_DESC, test_054_deps, test_entry, FALSE);
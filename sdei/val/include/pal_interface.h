@@ -77,6 +77,7 @@ int pal_invoke_sdei_fn(unsigned long function_id, unsigned long arg0,
             uint64_t *result);
 
 int pal_sdei_create_event_info_table(event_info_table_t *event_table);
+int pal_sdei_event_trigger(uint32_t event_num);
 void *pal_intf_alloc(int size);
 void pal_intf_free(void *handle);
 unsigned int pal_smp_pe_id(void);
@@ -140,6 +141,7 @@ typedef enum {
 
 void pal_pe_create_info_table(pe_info_table_t *pe_info_table_t);
 int pal_pe_execute_on_all(int num_pe, void *payload, uint64_t arg);
+int pal_pe_execute_on_all_concurrent(int num_pe, void *payload, uint64_t arg);
 void pal_pe_suspend(uint32_t power_state);
 void pal_pe_poweroff(uint32_t pe_index);
 void pal_pe_poweron(uint64_t pe_mpidr);
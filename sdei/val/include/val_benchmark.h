@@ -0,0 +1,55 @@
+/** @file
+ * Copyright (c) 2018, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+**/
+
+#ifndef __VAL_BENCHMARK_H
+#define __VAL_BENCHMARK_H
+
+/* Upper bound of PEs that take part in a benchmark, and samples kept per PE */
+#define BENCH_MAX_PE        64
+#define BENCH_MAX_SAMPLES   128
+
+#define BENCH_SYNC_TIMEOUT  0x1000000
+
+#ifdef TARGET_LINUX
+  #define BENCH_STR_FMT "%s"
+#else
+  #define BENCH_STR_FMT "%a"
+#endif
+
+extern volatile uint64_t g_bench_complete_ts;
+extern volatile uint64_t g_bench_resume_ts;
+
+typedef struct {
+    uint64_t min;
+    uint64_t max;
+    uint64_t mean;
+    uint64_t median;
+    uint64_t p99;
+    uint32_t count;
+} bench_stats_t;
+
+uint64_t val_bench_read_counter(void);
+uint64_t val_bench_ticks_to_ns(uint64_t ticks);
+uint64_t val_bench_us_to_ticks(uint64_t us);
+void val_bench_get_stats(uint64_t *samples, uint32_t count, bench_stats_t *stats);
+void val_bench_merge_stats(bench_stats_t *dst, bench_stats_t *src);
+void val_bench_report(uint32_t level, char *name, bench_stats_t *stats);
+void val_bench_sync_range(void *addr, uint32_t size);
+void val_bench_pe_barrier_reset(void);
+acs_status_t val_bench_pe_barrier(uint32_t num_pe, uint32_t phase);
+
+#endif /* __VAL_BENCHMARK_H */
@@ -29,7 +29,20 @@
 #endif
 
 #include "val_pe.h"
-#define val_print(verbosity, fmt, ...) pal_print(verbosity, fmt, ##__VA_ARGS__)
+/* Messages printed by a test that runs in a wave are held back by
+ * val_print_defer and printed under the test header once the wave is done.
+ * Arguments are kept as 64 bit values, so only integer formats are allowed
+ * in test output.
+ */
+#define VAL_PRINT_MAX_ARGS 4
+uint32_t val_print_defer(uint32_t verbosity, char *fmt, uint64_t *args, uint32_t num_args);
+#define val_print(verbosity, fmt, ...) \
+    do { \
+        uint64_t __print_args[] = {0, ##__VA_ARGS__}; \
+        if (!val_print_defer(verbosity, fmt, &__print_args[1], \
+                             sizeof(__print_args) / sizeof(uint64_t) - 1)) \
+            pal_print(verbosity, fmt, ##__VA_ARGS__); \
+    } while (0)
 #define val_print_raw(string, data) pal_print_raw(string, data)
 #define GIC_INFO_VERSION 3
 #define EVENT_STATUS_REGISTER_BIT (1 << 0)
@@ -76,6 +89,9 @@ val_pe_get_num(void);
 acs_status_t
 val_pe_execute_on_all(void *payload, uint64_t arg);
 
+acs_status_t
+val_pe_execute_on_all_concurrent(void *payload, uint64_t arg);
+
 acs_status_t
 val_pe_create_info_table(void *);
 
@@ -122,6 +138,9 @@ val_get_gicd_base(uint64_t *gicd_base);
 acs_status_t
 val_gic_get_version(uint32_t *version);
 
+acs_status_t
+val_gic_get_num_spi(uint32_t *num_spi);
+
 acs_status_t val_gic_install_isr(uint32_t int_id, void *isr);
 
 acs_status_t val_gic_end_of_interrupt(uint32_t int_id);
@@ -132,6 +151,11 @@ acs_status_t val_gic_get_interrupt_state(uint32_t int_id, uint32_t *status);
 
 acs_status_t val_gic_clear_interrupt(uint32_t int_id);
 
+acs_status_t val_gic_get_interrupt_enable(uint32_t int_id, uint32_t *enabled);
+
+acs_status_t val_gic_get_interrupt_pending(uint32_t int_id, uint32_t *pending);
+
+acs_status_t val_gic_enable_interrupt(uint32_t int_id);
 acs_status_t val_gic_disable_interrupt(uint32_t int_id);
 acs_status_t val_gic_generate_interrupt(uint32_t int_id);
 acs_status_t val_gic_free_interrupt(uint32_t int_id);
@@ -173,6 +197,9 @@ void val_intf_unlock(void);
 void asm_event_handler(void);
 void asm_handler_resume(void);
 void asm_handler_resume_context(void);
+void asm_event_handler_timed(void);
+void asm_event_handler_timed_resume(void);
+void asm_event_resume_timed(void);
 
 /*TIMER VAL APIs */
 typedef enum {
@@ -32,6 +32,11 @@
 #define NUM_EVENTS     3
 #define HEST_NOTIFY    4
 
+/* Event state tracked by the VAL event cache */
+#define SDEI_EVENT_STATE_REGISTERED  (1 << 0)
+#define SDEI_EVENT_STATE_ENABLED     (1 << 1)
+#define SDEI_EVENT_STATE_BOUND       (1 << 2)
+
 struct sdei_event {
     uint32_t         event_num;
     uint64_t         type;
@@ -53,9 +58,11 @@ uint32_t val_sdei_event_register(uint32_t event_num, uint64_t entry_point,
 int32_t val_sdei_event_enable(uint32_t event_num);
 uint32_t val_sdei_event_disable(uint32_t event_num);
 uint32_t val_event_get(uint32_t type, uint32_t priority);
+uint32_t val_event_get_state(uint32_t event_num, uint32_t *state);
 uint32_t val_sdei_event_signal(uint32_t event_num, uint64_t affinity);
 uint32_t val_acpi_present(void);
 int32_t val_sdei_event_unregister(uint32_t event_num);
+int32_t val_sdei_event_trigger(uint32_t event_num);
 
 uint32_t val_sdei_event_routing_set(uint32_t event_num, bool directed, int to_cpu);
 uint32_t val_sdei_event_routing_get(uint32_t event_num, bool *directed, int *to_cpu);
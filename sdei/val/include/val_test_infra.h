@@ -23,7 +23,24 @@
 #define SDEI_TEST_ABORT     0x5
 #define SDEI_TEST_SKIP      0x7
 
-#define SDEI_NUM_TESTS      49
+/* Test ids, taken from the test number in val_test_list.h */
+enum {
+#define SDEI_TEST(n) TEST_##n##_ID = 1##n - 1000,
+#include "val_test_list.h"
+#undef SDEI_TEST
+};
+
+/* Number of registered tests */
+enum {
+#define SDEI_TEST(n) SDEI_TEST_SLOT_##n,
+#include "val_test_list.h"
+#undef SDEI_TEST
+    SDEI_NUM_TESTS
+};
+
+/* Enable bitmap words; never fewer than the two the Linux app interface uses */
+#define SDEI_TEST_FLAG_WORDS \
+    (((SDEI_NUM_TESTS + 63) / 64) > 2 ? ((SDEI_NUM_TESTS + 63) / 64) : 2)
 
 #define PE_INFO_TABLE_SZ    8192
 #define GIC_INFO_TABLE_SZ   8192
@@ -31,9 +48,35 @@
 #define WD_INFO_TABLE_SZ    512
 #define TIMER_INFO_TABLE_SZ 1024
 
+/* Shared resources a test touches. Tests with disjoint resource masks and
+ * resolved dependencies may be scheduled on different PEs at the same time.
+ * Tests that do not declare their resources are treated as exclusive.
+ */
+#define SDEI_RES_NONE           0x0
+#define SDEI_RES_EVENT0         (1 << 0)
+#define SDEI_RES_SPI            (1 << 1)
+#define SDEI_RES_PPI            (1 << 2)
+#define SDEI_RES_WATCHDOG       (1 << 3)
+#define SDEI_RES_TIMER          (1 << 4)
+#define SDEI_RES_PE_MASK        (1 << 5)
+#define SDEI_RES_HEST_EVENTS    (1 << 6)
+#define SDEI_RES_EXCLUSIVE      0xFFFFFFFF
+
+/* Concurrent dispatch relies on MP safe console and log output, which the
+ * UEFI boot services do not provide. The UEFI build runs tests one at a time.
+ */
+#ifdef TARGET_LINUX
+  #define SDEI_MAX_PARALLEL_TESTS 8
+#else
+  #define SDEI_MAX_PARALLEL_TESTS 1
+#endif
+
 #define TEST_NONE_ID 0
 #define SDEI_PUBLISH_TEST(test, id, desc, deps, entry, all_pe) \
-                        sdei_test_desc test = {id, desc, deps, SDEI_TEST_PENDING, entry, all_pe}
+                        sdei_test_desc test = {id, desc, deps, SDEI_TEST_PENDING, entry, all_pe, \
+                                               SDEI_RES_EXCLUSIVE}
+#define SDEI_PUBLISH_TEST_RES(test, id, desc, deps, entry, all_pe, res) \
+                        sdei_test_desc test = {id, desc, deps, SDEI_TEST_PENDING, entry, all_pe, res}
 #define SDEI_DECLARE_TEST(test) extern sdei_test_desc test
 #define SDEI_SET_TEST_DEPS(deps, ...) static sdei_test_deps deps[] =  {__VA_ARGS__, TEST_NONE_ID}
 
@@ -49,12 +92,13 @@ typedef struct sdei_test_desc {
     uint32_t status;
     sdei_test_fn test_fn;
     int32_t all_pe;
+    uint32_t resources;
 } sdei_test_desc;
 
 typedef uint64_t test_flags;
 
 typedef struct sdei_test_control {
-    test_flags flags[2]; //which tests to run?
+    test_flags flags[SDEI_TEST_FLAG_WORDS]; //which tests to run?
     uint32_t tests_skipped;
     uint32_t tests_passed;
     uint32_t tests_failed;
@@ -71,149 +115,6 @@ void val_test_set_status(uint32_t num_pe, uint32_t status);
 uint32_t val_test_pe_get_status(uint32_t index);
 uint32_t val_test_get_status(uint32_t num_pe, uint64_t timeout);
 
-#define TEST_001_ID 1
-SDEI_DECLARE_TEST(test_001);
-
-#define TEST_002_ID 2
-SDEI_DECLARE_TEST(test_002);
-
-#define TEST_003_ID 3
-SDEI_DECLARE_TEST(test_003);
-
-#define TEST_004_ID 4
-SDEI_DECLARE_TEST(test_004);
-
-#define TEST_005_ID 5
-SDEI_DECLARE_TEST(test_005);
-
-#define TEST_006_ID 6
-SDEI_DECLARE_TEST(test_006);
-
-#define TEST_007_ID 7
-SDEI_DECLARE_TEST(test_007);
-
-#define TEST_008_ID 8
-SDEI_DECLARE_TEST(test_008);
-
-#define TEST_009_ID 9
-SDEI_DECLARE_TEST(test_009);
-
-#define TEST_010_ID 10
-SDEI_DECLARE_TEST(test_010);
-
-#define TEST_011_ID 11
-SDEI_DECLARE_TEST(test_011);
-
-#define TEST_012_ID 12
-SDEI_DECLARE_TEST(test_012);
-
-#define TEST_013_ID 13
-SDEI_DECLARE_TEST(test_013);
-
-#define TEST_014_ID 14
-SDEI_DECLARE_TEST(test_014);
-
-#define TEST_015_ID 15
-SDEI_DECLARE_TEST(test_015);
-
-#define TEST_016_ID 16
-SDEI_DECLARE_TEST(test_016);
-
-#define TEST_017_ID 17
-SDEI_DECLARE_TEST(test_017);
-
-#define TEST_018_ID 18
-SDEI_DECLARE_TEST(test_018);
-
-#define TEST_019_ID 19
-SDEI_DECLARE_TEST(test_019);
-
-#define TEST_020_ID 20
-SDEI_DECLARE_TEST(test_020);
-
-#define TEST_021_ID 21
-SDEI_DECLARE_TEST(test_021);
-
-#define TEST_022_ID 22
-SDEI_DECLARE_TEST(test_022);
-
-#define TEST_023_ID 23
-SDEI_DECLARE_TEST(test_023);
-
-#define TEST_024_ID 24
-SDEI_DECLARE_TEST(test_024);
-
-#define TEST_025_ID 25
-SDEI_DECLARE_TEST(test_025);
-
-#define TEST_026_ID 26
-SDEI_DECLARE_TEST(test_026);
-
-#define TEST_027_ID 27
-SDEI_DECLARE_TEST(test_027);
-
-#define TEST_028_ID 28
-SDEI_DECLARE_TEST(test_028);
-
-#define TEST_029_ID 29
-SDEI_DECLARE_TEST(test_029);
-
-#define TEST_030_ID 30
-SDEI_DECLARE_TEST(test_030);
-
-#define TEST_031_ID 31
-SDEI_DECLARE_TEST(test_031);
-
-#define TEST_032_ID 32
-SDEI_DECLARE_TEST(test_032);
-
-#define TEST_033_ID 33
-SDEI_DECLARE_TEST(test_033);
-
-#define TEST_034_ID 34
-SDEI_DECLARE_TEST(test_034);
-
-#define TEST_035_ID 35
-SDEI_DECLARE_TEST(test_035);
-
-#define TEST_036_ID 36
-SDEI_DECLARE_TEST(test_036);
-
-#define TEST_037_ID 37
-SDEI_DECLARE_TEST(test_037);
-
-#define TEST_038_ID 38
-SDEI_DECLARE_TEST(test_038);
-
-#define TEST_039_ID 39
-SDEI_DECLARE_TEST(test_039);
-
-#define TEST_040_ID 40
-SDEI_DECLARE_TEST(test_040);
-
-#define TEST_041_ID 41
-SDEI_DECLARE_TEST(test_041);
-
-#define TEST_042_ID 42
-SDEI_DECLARE_TEST(test_042);
-
-#define TEST_043_ID 43
-SDEI_DECLARE_TEST(test_043);
-
-#define TEST_044_ID 44
-SDEI_DECLARE_TEST(test_044);
-
-#define TEST_045_ID 45
-SDEI_DECLARE_TEST(test_045);
-
-#define TEST_046_ID 46
-SDEI_DECLARE_TEST(test_046);
-
-#define TEST_047_ID 47
-SDEI_DECLARE_TEST(test_047);
-
-#define TEST_048_ID 48
-SDEI_DECLARE_TEST(test_048);
-
-#define TEST_049_ID 49
-SDEI_DECLARE_TEST(test_049);
+#define SDEI_TEST(n) SDEI_DECLARE_TEST(test_##n);
+#include "val_test_list.h"
+#undef SDEI_TEST
@@ -0,0 +1,75 @@
+/** @file
+ * Copyright (c) 2018, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+**/
+
+/* Registered SDEI tests, in run order. Each entry publishes test_<n> with
+ * TEST_<n>_ID = <n>. A new test needs an entry here, plus its source file in
+ * test_pool/Makefile and uefi_app/SdeiAcs.inf.
+ */
+SDEI_TEST(001)
+SDEI_TEST(002)
+SDEI_TEST(003)
+SDEI_TEST(004)
+SDEI_TEST(005)
+SDEI_TEST(006)
+SDEI_TEST(007)
+SDEI_TEST(008)
+SDEI_TEST(009)
+SDEI_TEST(010)
+SDEI_TEST(011)
+SDEI_TEST(012)
+SDEI_TEST(013)
+SDEI_TEST(014)
+SDEI_TEST(015)
+SDEI_TEST(016)
+SDEI_TEST(017)
+SDEI_TEST(018)
+SDEI_TEST(019)
+SDEI_TEST(020)
+SDEI_TEST(021)
+SDEI_TEST(022)
+SDEI_TEST(023)
+SDEI_TEST(024)
+SDEI_TEST(025)
+SDEI_TEST(026)
+SDEI_TEST(027)
+SDEI_TEST(028)
+SDEI_TEST(029)
+SDEI_TEST(030)
+SDEI_TEST(031)
+SDEI_TEST(032)
+SDEI_TEST(033)
+SDEI_TEST(034)
+SDEI_TEST(035)
+SDEI_TEST(036)
+SDEI_TEST(037)
+SDEI_TEST(038)
+SDEI_TEST(039)
+SDEI_TEST(040)
+SDEI_TEST(041)
+SDEI_TEST(042)
+SDEI_TEST(043)
+SDEI_TEST(044)
+SDEI_TEST(045)
+SDEI_TEST(046)
+SDEI_TEST(047)
+SDEI_TEST(048)
+SDEI_TEST(049)
+SDEI_TEST(050)
+SDEI_TEST(051)
+SDEI_TEST(052)
+SDEI_TEST(053)
+SDEI_TEST(054)
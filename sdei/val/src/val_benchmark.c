@@ -0,0 +1,235 @@
+/** @file
+ * Copyright (c) 2018, Arm Limited or its affiliates. All rights reserved.
+ * SPDX-License-Identifier : Apache-2.0
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ *  http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ **/
+
+#include "val_interface.h"
+#include "val_timer.h"
+#include "val_benchmark.h"
+
+/* One arrival slot per PE, each on its own cache line */
+typedef struct {
+    volatile uint64_t phase;
+    uint64_t pad[7];
+} bench_sync_t;
+
+static bench_sync_t g_bench_sync[BENCH_MAX_PE];
+
+/* Written by the timed event handler trampolines in event_handler.S. Only one
+ * PE takes timed events at a time.
+ */
+volatile uint64_t g_bench_complete_ts;
+volatile uint64_t g_bench_resume_ts;
+
+/**
+ *  @brief   This API reads the physical counter used to time benchmarks.
+ *           SMC and HVC are context synchronizing, so the counter reads that
+ *           bracket an SDEI call are not reordered around it.
+ *
+ *  @return  current count of CNTPCT_EL0
+ */
+uint64_t val_bench_read_counter(void)
+{
+    return ArmReadCntPct();
+}
+
+/**
+ *  @brief   This API converts physical counter ticks into nanoseconds.
+ *  @param ticks  Number of counter ticks
+ *
+ *  @return  time in nanoseconds, or the raw ticks if CNTFRQ is not programmed
+ */
+uint64_t val_bench_ticks_to_ns(uint64_t ticks)
+{
+    uint64_t freq = ArmReadCntFrq();
+
+    if (!freq)
+        return ticks;
+
+    return (ticks * 1000000000ULL) / freq;
+}
+
+/**
+ *  @brief   This API converts a duration in microseconds into physical counter ticks.
+ *  @param us  Duration in microseconds
+ *
+ *  @return  number of ticks, or the raw duration if CNTFRQ is not programmed
+ */
+uint64_t val_bench_us_to_ticks(uint64_t us)
+{
+    uint64_t freq = ArmReadCntFrq();
+
+    if (!freq)
+        return us;
+
+    return (us * freq) / 1000000ULL;
+}
+
+/**
+ *  @brief   This API sorts the samples in place and computes their distribution.
+ *  @param samples  Array of samples, sorted on return
+ *  @param count    Number of samples
+ *  @param stats    Distribution of the samples
+ *
+ *  @return  none
+ */
+void val_bench_get_stats(uint64_t *samples, uint32_t count, bench_stats_t *stats)
+{
+    uint32_t i, j;
+    uint64_t key, sum = 0;
+
+    stats->count = count;
+    if (!count) {
+        stats->min = stats->max = stats->mean = stats->median = stats->p99 = 0;
+        return;
+    }
+
+    /* Sample counts are small, insertion sort keeps the stack usage minimal */
+    for (i = 1; i < count; i++) {
+        key = samples[i];
+        for (j = i; j > 0 && samples[j - 1] > key; j--)
+            samples[j] = samples[j - 1];
+        samples[j] = key;
+    }
+
+    for (i = 0; i < count; i++)
+        sum += samples[i];
+
+    stats->min = samples[0];
+    stats->max = samples[count - 1];
+    stats->mean = sum / count;
+    stats->median = samples[count / 2];
+    stats->p99 = samples[((count * 99) / 100 < count) ? (count * 99) / 100 : count - 1];
+}
+
+/**
+ *  @brief   This API folds the distribution of one PE into a system wide summary.
+ *           The merged median and 99th percentile are those of the worst PE.
+ *  @param dst  Summary, must be zeroed before the first merge
+ *  @param src  Distribution to merge
+ *
+ *  @return  none
+ */
+void val_bench_merge_stats(bench_stats_t *dst, bench_stats_t *src)
+{
+    if (!src->count)
+        return;
+
+    if (!dst->count) {
+        *dst = *src;
+        return;
+    }
+
+    dst->mean = ((dst->mean * dst->count) + (src->mean * src->count)) /
+                (dst->count + src->count);
+    dst->count += src->count;
+    if (src->min < dst->min)
+        dst->min = src->min;
+    if (src->max > dst->max)
+        dst->max = src->max;
+    if (src->median > dst->median)
+        dst->median = src->median;
+    if (src->p99 > dst->p99)
+        dst->p99 = src->p99;
+}
+
+/**
+ *  @brief   This API prints a distribution of counter ticks in nanoseconds.
+ *  @param level  Print verbosity
+ *  @param name   Name of the measured quantity
+ *  @param stats  Distribution in counter ticks
+ *
+ *  @return  none
+ */
+void val_bench_report(uint32_t level, char *name, bench_stats_t *stats)
+{
+    val_print(level, "\n        " BENCH_STR_FMT, (uint64_t)name);
+    val_print(level, " min %lld med %lld",
+              val_bench_ticks_to_ns(stats->min), val_bench_ticks_to_ns(stats->median));
+    val_print(level, " p99 %lld max %lld",
+              val_bench_ticks_to_ns(stats->p99), val_bench_ticks_to_ns(stats->max));
+    val_print(level, " mean %lld ns (%d samples)",
+              val_bench_ticks_to_ns(stats->mean), stats->count);
+}
+
+/**
+ *  @brief   This API makes a buffer written by one PE visible to the others.
+ *           Cache maintenance is done for every 16 bytes, the smallest data
+ *           cache line allowed by the architecture.
+ *  @param addr  Start of the buffer
+ *  @param size  Size of the buffer in bytes
+ *
+ *  @return  none
+ */
+void val_bench_sync_range(void *addr, uint32_t size)
+{
+    uint64_t va = (uint64_t)addr & ~0xFULL;
+    uint64_t end = (uint64_t)addr + size;
+
+    for (; va < end; va += 16)
+        val_pe_data_cache_clean_invalidate(va);
+}
+
+/**
+ *  @brief   This API clears the rendezvous state of all PEs. It is called by the
+ *           primary PE before the payload that uses val_bench_pe_barrier is
+ *           dispatched.
+ *
+ *  @return  none
+ */
+void val_bench_pe_barrier_reset(void)
+{
+    uint32_t i;
+
+    for (i = 0; i < BENCH_MAX_PE; i++) {
+        g_bench_sync[i].phase = 0;
+        val_pe_data_cache_clean_invalidate((uint64_t)&g_bench_sync[i].phase);
+    }
+}
+
+/**
+ *  @brief   This API holds the calling PE until the first num_pe PEs have
+ *           reached the same phase. Phases must increase between calls.
+ *  @param num_pe  Number of PEs taking part
+ *  @param phase   Non-zero phase number of this rendezvous
+ *
+ *  @return  ACS_SUCCESS, or ACS_ERROR if a PE did not arrive in time
+ */
+acs_status_t val_bench_pe_barrier(uint32_t num_pe, uint32_t phase)
+{
+    uint32_t i, index = val_pe_get_index();
+    uint64_t timeout = BENCH_SYNC_TIMEOUT;
+
+    if (index >= BENCH_MAX_PE)
+        return ACS_ERROR;
+
+    if (num_pe > BENCH_MAX_PE)
+        num_pe = BENCH_MAX_PE;
+
+    g_bench_sync[index].phase = phase;
+    val_pe_data_cache_clean_invalidate((uint64_t)&g_bench_sync[index].phase);
+
+    for (i = 0; i < num_pe; i++) {
+        while (1) {
+            val_pe_data_cache_invalidate((uint64_t)&g_bench_sync[i].phase);
+            if (g_bench_sync[i].phase >= phase)
+                break;
+            if (!timeout--)
+                return ACS_ERROR;
+        }
+    }
+
+    return ACS_SUCCESS;
+}
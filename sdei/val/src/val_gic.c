@@ -17,6 +17,7 @@
 
 #include "val_interface.h"
 
+#define GICD_TYPER          0x004
 #define GICD_CLRSPI_NSR     0x048
 #define GICD_CLRLPIR        0x048
 #define GICD_ISENABLER      0x100
@@ -126,6 +127,28 @@ acs_status_t val_gic_get_version(uint32_t *version)
     return ACS_SUCCESS;
 }
 
+/**
+ * @brief   This function returns the number of SPI INTIDs implemented by the
+ *           distributor, from GICD_TYPER.ITLinesNumber.
+ * @param   num_spi  Number of SPIs, starting at INTID 32
+ * @return  status
+ */
+acs_status_t val_gic_get_num_spi(uint32_t *num_spi)
+{
+    uint32_t it_lines;
+
+    if (!num_spi)
+        return ACS_ERROR;
+
+    it_lines = val_mmio_read(g_gicd_base + GICD_TYPER) & 0x1F;
+    *num_spi = 32 * (it_lines + 1) - 32;
+    /* INTIDs 1020 to 1023 are special */
+    if (*num_spi > 988)
+        *num_spi = 988;
+
+    return ACS_SUCCESS;
+}
+
 /**
  * @brief   This function is installs the ISR pointed by the function pointer
  *          the input Interrupt ID.
@@ -363,6 +386,71 @@ acs_status_t val_gic_get_interrupt_state(uint32_t int_id, uint32_t *status)
     return ACS_SUCCESS;
 }
 
+/**
+ * @brief   This function returns whether an SPI is enabled in the distributor,
+ *          from GICD_ISENABLER.
+ *          1. Caller       -  Test Suite
+ *          2. Prerequisite -  val_gic_create_info_table
+ * @param   int_id  SPI Interrupt ID
+ * @param   enabled 1 if the interrupt is enabled
+ * @return  status
+ */
+acs_status_t val_gic_get_interrupt_enable(uint32_t int_id, uint32_t *enabled)
+{
+    uint32_t reg_offset = int_id / 32;
+    uint32_t reg_shift  = int_id % 32;
+
+    if (!enabled || (int_id < 32) || (int_id > 1019))
+        return ACS_ERROR;
+
+    *enabled = (val_mmio_read(g_gicd_base + GICD_ISENABLER + (4 * reg_offset)) >> reg_shift) & 1;
+    return ACS_SUCCESS;
+}
+
+/**
+ * @brief   This function returns whether an SPI is pending in the distributor,
+ *          from GICD_ISPENDR. Unlike val_gic_get_interrupt_state, the active
+ *          state is ignored and nothing is printed.
+ *          1. Caller       -  Test Suite
+ *          2. Prerequisite -  val_gic_create_info_table
+ * @param   int_id  SPI Interrupt ID
+ * @param   pending 1 if the interrupt is pending
+ * @return  status
+ */
+acs_status_t val_gic_get_interrupt_pending(uint32_t int_id, uint32_t *pending)
+{
+    uint32_t reg_offset = int_id / 32;
+    uint32_t reg_shift  = int_id % 32;
+
+    if (!pending || (int_id < 32) || (int_id > 1019))
+        return ACS_ERROR;
+
+    *pending = (val_mmio_read(g_gicd_base + GICD_ISPENDR + (4 * reg_offset)) >> reg_shift) & 1;
+    return ACS_SUCCESS;
+}
+
+/**
+ * @brief   This function enables an SPI in the distributor. It undoes
+ *          val_gic_disable_interrupt when a test restores the state it found.
+ *          1. Caller       -  Test Suite
+ *          2. Prerequisite -  val_gic_create_info_table
+ * @param   int_id  SPI Interrupt ID
+ * @return  status
+ */
+acs_status_t val_gic_enable_interrupt(uint32_t int_id)
+{
+    uint32_t reg_offset = int_id / 32;
+    uint32_t reg_shift  = int_id % 32;
+
+    if ((int_id < 32) || (int_id > 1019)) {
+        val_print(ACS_LOG_ERR, "\n        Invalid Interrupt ID number %d", int_id);
+        return ACS_ERROR;
+    }
+
+    val_mmio_write(g_gicd_base + GICD_ISENABLER + (4 * reg_offset), 1 << reg_shift);
+    return ACS_SUCCESS;
+}
+
 /**
  * @brief   This function will clear an interrupt that is pending or active.
  *          1. Caller       -  Test Suite
@@ -325,6 +325,24 @@ acs_status_t val_pe_execute_on_all(void *payload, uint64_t arg)
     return status;
 }
 
+/**
+ *  @brief   This API executes code addressed by given function pointer on each PE
+ *           in the system, with all PEs running the payload at the same time.
+ *  @param payload  function pointer
+ *  @param arg   arguments to the fuction
+ *
+ *  @return  status
+ */
+acs_status_t val_pe_execute_on_all_concurrent(void *payload, uint64_t arg)
+{
+#ifdef TARGET_LINUX
+    /* The Linux PAL already runs the payload on all PEs in parallel */
+    return val_pe_execute_on_all(payload, arg);
+#else
+    return pal_pe_execute_on_all_concurrent(val_pe_get_num(), payload, arg);
+#endif
+}
+
 /**
  *  @brief   This API suspends the current PE using PSCI call
  *  @param  none
@@ -23,6 +23,123 @@
 
 event_info_table_t *g_event_info_table;
 
+/* Event attributes do not change during a run, so they are queried once when
+ * the event info table is created. The HEST events are followed by the
+ * events bound through val_sdei_interrupt_bind, whose state is tracked until
+ * they are released. Entries are never moved, a released one is marked free
+ * with EVENT_CACHE_NONE and reused by the next bind.
+ */
+#define EVENT_CACHE_MAX     32
+#define EVENT_CACHE_NONE    0xFFFFFFFF
+
+typedef struct {
+    uint32_t number;
+    uint32_t irq;
+    uint32_t type;
+    uint32_t priority;
+    uint32_t routing_mode;
+    uint32_t state;
+} sdei_event_cache_t;
+
+static sdei_event_cache_t g_event_cache[EVENT_CACHE_MAX];
+static uint32_t g_event_cache_num;
+static uint32_t g_event_cache_hest;
+/* First HEST event of each (type, priority) pair */
+static uint32_t g_event_index[2][2];
+
+static sdei_event_cache_t *event_cache_find(uint32_t event_num)
+{
+    uint32_t i;
+
+    for (i = 0; i < g_event_cache_num; i++)
+        if (g_event_cache[i].number == event_num)
+            return &g_event_cache[i];
+    return NULL;
+}
+
+static void event_cache_update(uint32_t event_num, uint32_t set, uint32_t clear)
+{
+    sdei_event_cache_t *entry;
+
+    /* No lock here, event handlers register and unregister events. As entries
+     * are never moved, the one found stays that of event_num unless the event
+     * is released at the same time.
+     */
+    entry = event_cache_find(event_num);
+    if (entry)
+        entry->state = (entry->state & ~clear) | set;
+}
+
+static void event_cache_bind(uint32_t irq_num, uint32_t event_num)
+{
+    sdei_event_cache_t *entry;
+
+    pal_intf_lock();
+    entry = event_cache_find(event_num);
+    if (entry == NULL) {
+        /* Reuse a released entry before growing the table */
+        entry = event_cache_find(EVENT_CACHE_NONE);
+        if (entry == NULL && g_event_cache_num < EVENT_CACHE_MAX)
+            entry = &g_event_cache[g_event_cache_num++];
+        if (entry) {
+            /* Bound events have normal priority, PPIs give private events */
+            entry->type = (irq_num < 32) ? SDEI_EVENT_TYPE_PRIVATE : SDEI_EVENT_TYPE_SHARED;
+            entry->priority = SDEI_EVENT_PRIORITY_NORMAL;
+            entry->routing_mode = SDEI_EVENT_REGISTER_RM_ANY;
+            entry->state = 0;
+            entry->number = event_num;
+        }
+    }
+    if (entry) {
+        entry->irq = irq_num;
+        entry->state |= SDEI_EVENT_STATE_BOUND;
+    }
+    pal_intf_unlock();
+}
+
+static void event_cache_release(uint32_t event_num)
+{
+    sdei_event_cache_t *entry;
+
+    pal_intf_lock();
+    entry = event_cache_find(event_num);
+    if (entry && entry >= &g_event_cache[g_event_cache_hest]) {
+        entry->number = EVENT_CACHE_NONE;
+        entry->irq = SDEI_EVENT_UNBOUND;
+        entry->state = 0;
+    }
+    pal_intf_unlock();
+}
+
+static void event_cache_reset(uint32_t type)
+{
+    uint32_t i;
+
+    pal_intf_lock();
+    for (i = 0; i < g_event_cache_num; i++)
+        if (g_event_cache[i].type == type)
+            g_event_cache[i].state &= ~(SDEI_EVENT_STATE_REGISTERED | SDEI_EVENT_STATE_ENABLED);
+    /* A shared reset releases all bound interrupts */
+    if (type == SDEI_EVENT_TYPE_SHARED) {
+        for (i = g_event_cache_hest; i < g_event_cache_num; i++) {
+            g_event_cache[i].number = EVENT_CACHE_NONE;
+            g_event_cache[i].irq = SDEI_EVENT_UNBOUND;
+            g_event_cache[i].state = 0;
+        }
+    }
+    pal_intf_unlock();
+}
+
+static uint32_t event_cache_bound(uint32_t irq_num)
+{
+    uint32_t i;
+
+    for (i = g_event_cache_hest; i < g_event_cache_num; i++)
+        if (g_event_cache[i].irq == irq_num && (g_event_cache[i].state & SDEI_EVENT_STATE_BOUND))
+            return g_event_cache[i].number;
+    return 0;
+}
+
 uint32_t val_acpi_present() {
 
     if (!pal_acpi_present()) {
@@ -123,6 +240,54 @@ static int32_t val_event_create(struct sdei_event *event)
     return err;
 }
 
+static void event_cache_create(void)
+{
+    struct sdei_event event;
+    sdei_event_cache_t *entry;
+    event_info_t *event_info = &g_event_info_table->info[0];
+    uint64_t routing_mode;
+    uint32_t i;
+
+    g_event_cache_num = 0;
+    g_event_index[0][0] = g_event_index[0][1] = EVENT_CACHE_NONE;
+    g_event_index[1][0] = g_event_index[1][1] = EVENT_CACHE_NONE;
+
+    for (i = 0; i < g_event_info_table->num_ghes_notify; i++, event_info++) {
+        if (event_info->number == 0 || event_cache_find(event_info->number))
+            continue;
+        if (g_event_cache_num == EVENT_CACHE_MAX) {
+            val_print(ACS_LOG_WARN, "\n        EVT_INFO: Event cache full, %d not cached",
+                                                                    event_info->number);
+            continue;
+        }
+
+        event.event_num = event_info->number;
+        if (val_event_create(&event)) {
+            val_print(ACS_LOG_WARN, "\n        EVT_INFO: Failed to query event %d",
+                                                                    event.event_num);
+            continue;
+        }
+        /* Routing mode is only defined for shared events */
+        if (val_sdei_event_get_info(event.event_num, SDEI_EVENT_INFO_EV_ROUTING_MODE,
+                                                                    &routing_mode))
+            routing_mode = SDEI_EVENT_REGISTER_RM_ANY;
+
+        entry = &g_event_cache[g_event_cache_num];
+        entry->number = event.event_num;
+        entry->irq = SDEI_EVENT_UNBOUND;
+        entry->type = event.type;
+        entry->priority = event.priority;
+        entry->routing_mode = routing_mode;
+        entry->state = 0;
+        if (event.type <= SDEI_EVENT_TYPE_SHARED &&
+            event.priority <= SDEI_EVENT_PRIORITY_CRITICAL &&
+            g_event_index[event.type][event.priority] == EVENT_CACHE_NONE)
+            g_event_index[event.type][event.priority] = g_event_cache_num;
+        g_event_cache_num++;
+    }
+    g_event_cache_hest = g_event_cache_num;
+}
+
 /**
  *  @brief   This function returns event number based on the given type
  *
@@ -132,12 +297,14 @@ static int32_t val_event_create(struct sdei_event *event)
  */
 uint32_t val_event_get(uint32_t type, uint32_t priority)
 {
-    struct sdei_event event;
-    int err, i;
+    int err;
     uint32_t event_num = 0;
-    event_info_t *event_info = &g_event_info_table->info[0];
+    uint32_t t, p, first = EVENT_CACHE_NONE;
 
     if (type == SDEI_EVENT_TYPE_PRIVATE) {
+        event_num = event_cache_bound(PPI_INTR_NUM);
+        if (event_num)
+            return event_num;
         err = val_sdei_interrupt_bind(PPI_INTR_NUM, &event_num);
         if (err) {
             val_print(ACS_LOG_ERR, "\n        PPI Interrupt bind failed with err %d", err);
@@ -145,29 +312,74 @@ uint32_t val_event_get(uint32_t type, uint32_t priority)
         return event_num;
     }
     else if (type == SDEI_EVENT_TYPE_SHARED) {
-         err = val_sdei_interrupt_bind(SPI_INTR_NUM, &event_num);
+        event_num = event_cache_bound(SPI_INTR_NUM);
+        if (event_num)
+            return event_num;
+        err = val_sdei_interrupt_bind(SPI_INTR_NUM, &event_num);
         if (err) {
             val_print(ACS_LOG_ERR, "\n        SPI Interrupt bind failed with err %d", err);
         }
         return event_num;
     }
 
-    for (i = 0; i < g_event_info_table->num_events; i++) {
-        event.event_num = event_info->number;
-        if (priority == SDEI_EVENT_PRIORITY_ANY && type == SDEI_EVENT_TYPE_ANY)
-            return event.event_num;
-        err = val_event_create(&event);
-        if (err)
-            return 0;
-
-        if ((priority == event.priority && type == event.type) ||
-            (priority == SDEI_EVENT_PRIORITY_ANY && type == event.type) ||
-            (priority == event.priority && type == SDEI_EVENT_TYPE_ANY))
-            return event.event_num;
+    if (type == SDEI_EVENT_TYPE_ANY && priority == SDEI_EVENT_PRIORITY_ANY)
+        return g_event_cache_hest ? g_event_cache[0].number : 0;
+
+    for (t = SDEI_EVENT_TYPE_PRIVATE; t <= SDEI_EVENT_TYPE_SHARED; t++) {
+        if (type != SDEI_EVENT_TYPE_ANY && type != t)
+            continue;
+        for (p = SDEI_EVENT_PRIORITY_NORMAL; p <= SDEI_EVENT_PRIORITY_CRITICAL; p++) {
+            if (priority != SDEI_EVENT_PRIORITY_ANY && priority != p)
+                continue;
+            if (g_event_index[t][p] < first)
+                first = g_event_index[t][p];
+        }
     }
+    return (first == EVENT_CACHE_NONE) ? 0 : g_event_cache[first].number;
+}
+
+/**
+ *  @brief   This function returns the state of an event as last set through the VAL.
+ *  @param event_num  Event number
+ *  @param state      SDEI_EVENT_STATE_* flags
+ *
+ *  @return  0 if the event is cached, 1 otherwise
+ */
+uint32_t val_event_get_state(uint32_t event_num, uint32_t *state)
+{
+    sdei_event_cache_t *entry = event_cache_find(event_num);
+
+    if (entry == NULL)
+        return 1;
+    *state = entry->state;
     return 0;
 }
 
+/**
+ *  @brief   This function raises an event. An event bound to an interrupt is
+ *           raised by pending the interrupt, other platform events through the
+ *           platform specific trigger of the PAL.
+ *  @param event_num  Event number
+ *
+ *  @return  0 on success, SDEI_STATUS_NOT_SUPPORTED if the platform cannot raise it
+ */
+int32_t val_sdei_event_trigger(uint32_t event_num)
+{
+    sdei_event_cache_t *entry;
+
+    /* No lock, this is called from event handlers, see event_cache_update */
+    entry = event_cache_find(event_num);
+    if (entry && entry->irq != SDEI_EVENT_UNBOUND)
+        return val_gic_generate_interrupt(entry->irq) ? SDEI_STATUS_NOT_SUPPORTED : 0;
+
+#ifdef TARGET_LINUX
+    /* Platform event triggers are only provided by the UEFI PAL */
+    return SDEI_STATUS_NOT_SUPPORTED;
+#else
+    return pal_sdei_event_trigger(event_num);
+#endif
+}
+
 /**
  *  @brief   This function returns the version of SDEI dispatcher.
  *
@@ -210,6 +422,8 @@ int32_t val_sdei_private_reset(void *ignored)
 
     err = pal_invoke_sdei_fn(SDEI_1_0_FN_SDEI_PRIVATE_RESET, 0, 0, 0, 0, 0,
                  NULL);
+    if (!err)
+        event_cache_reset(SDEI_EVENT_TYPE_PRIVATE);
     return err;
 }
 
@@ -221,8 +435,13 @@ int32_t val_sdei_private_reset(void *ignored)
  */
 int32_t val_sdei_shared_reset(void)
 {
-    return pal_invoke_sdei_fn(SDEI_1_0_FN_SDEI_SHARED_RESET, 0, 0, 0, 0, 0,
+    int32_t err;
+
+    err = pal_invoke_sdei_fn(SDEI_1_0_FN_SDEI_SHARED_RESET, 0, 0, 0, 0, 0,
                   NULL);
+    if (!err)
+        event_cache_reset(SDEI_EVENT_TYPE_SHARED);
+    return err;
 }
 
 /**
@@ -247,8 +466,13 @@ int32_t val_sdei_event_status(uint32_t event_num, uint64_t *result)
  */
 int32_t val_sdei_event_enable(uint32_t event_num)
 {
-    return pal_invoke_sdei_fn(SDEI_1_0_FN_SDEI_EVENT_ENABLE, event_num, 0, 0, 0,
+    int32_t err;
+
+    err = pal_invoke_sdei_fn(SDEI_1_0_FN_SDEI_EVENT_ENABLE, event_num, 0, 0, 0,
                   0, NULL);
+    if (!err)
+        event_cache_update(event_num, SDEI_EVENT_STATE_ENABLED, 0);
+    return err;
 }
 
 /**
@@ -259,8 +483,13 @@ int32_t val_sdei_event_enable(uint32_t event_num)
  */
 uint32_t val_sdei_event_disable(uint32_t event_num)
 {
-    return pal_invoke_sdei_fn(SDEI_1_0_FN_SDEI_EVENT_DISABLE, event_num, 0, 0,
+    uint32_t err;
+
+    err = pal_invoke_sdei_fn(SDEI_1_0_FN_SDEI_EVENT_DISABLE, event_num, 0, 0,
                   0, 0, NULL);
+    if (!err)
+        event_cache_update(event_num, 0, SDEI_EVENT_STATE_ENABLED);
+    return err;
 }
 
 /**
@@ -277,6 +506,8 @@ int32_t val_sdei_interrupt_bind(uint32_t irq_num, uint32_t *event_num)
     err = pal_invoke_sdei_fn(SDEI_1_0_FN_SDEI_INTERRUPT_BIND, irq_num, 0, 0, 0,
                  0, &result);
     *event_num = result;
+    if (!err)
+        event_cache_bind(irq_num, result);
 
     return err;
 }
@@ -289,8 +520,13 @@ int32_t val_sdei_interrupt_bind(uint32_t irq_num, uint32_t *event_num)
  */
 int32_t val_sdei_interrupt_release(uint32_t event_num)
 {
-    return pal_invoke_sdei_fn(SDEI_1_0_FN_SDEI_INTERRUPT_RELEASE, event_num, 0,
+    int32_t err;
+
+    err = pal_invoke_sdei_fn(SDEI_1_0_FN_SDEI_INTERRUPT_RELEASE, event_num, 0,
                   0, 0, 0, NULL);
+    if (!err)
+        event_cache_release(event_num);
+    return err;
 }
 
 /**
@@ -301,8 +537,15 @@ int32_t val_sdei_interrupt_release(uint32_t event_num)
  */
 int32_t val_sdei_event_unregister(uint32_t event_num)
 {
-    return pal_invoke_sdei_fn(SDEI_1_0_FN_SDEI_EVENT_UNREGISTER, event_num, 0,
+    int32_t err;
+
+    err = pal_invoke_sdei_fn(SDEI_1_0_FN_SDEI_EVENT_UNREGISTER, event_num, 0,
                   0, 0, 0, NULL);
+    /* A pending unregister completes when the running handler finishes */
+    if (!err || err == SDEI_STATUS_PENDING)
+        event_cache_update(event_num, 0,
+                           SDEI_EVENT_STATE_REGISTERED | SDEI_EVENT_STATE_ENABLED);
+    return err;
 }
 
 /**
@@ -331,9 +574,14 @@ uint32_t val_sdei_event_signal(uint32_t event_num, uint64_t affinity)
 uint32_t val_sdei_event_register(uint32_t event_num, uint64_t entry_point,
                    void *arg, uint64_t flags, uint64_t affinity)
 {
-    return pal_invoke_sdei_fn(SDEI_1_0_FN_SDEI_EVENT_REGISTER, event_num,
+    uint32_t err;
+
+    err = pal_invoke_sdei_fn(SDEI_1_0_FN_SDEI_EVENT_REGISTER, event_num,
                   (uint64_t)entry_point, (uint64_t)arg,
                   flags, affinity, NULL);
+    if (!err)
+        event_cache_update(event_num, SDEI_EVENT_STATE_REGISTERED, 0);
+    return err;
 }
 
 static uint32_t sdei_event_routing_set(uint32_t event_num, uint64_t routing_mode,
@@ -433,6 +681,7 @@ acs_status_t val_sdei_create_event_info_table(uint64_t *table)
     }
 
     val_pe_data_cache_clean_invalidate((uint64_t)&g_event_info_table);
+    event_cache_create();
     return ACS_SUCCESS;
 }
 
@@ -21,23 +21,146 @@
 extern sdei_log_control g_log_control;
 sdei_test_desc sdei_test[SDEI_NUM_TESTS];
 
-static int is_test_passed(int test_id) {
-    int i;
+static sdei_test_desc *const g_test_list[] = {
+#define SDEI_TEST(n) &test_##n,
+#include "val_test_list.h"
+#undef SDEI_TEST
+};
+
+/* Test id to sdei_test[] slot, allocated by val_test_init */
+static uint32_t *g_test_slot_map;
+static uint32_t g_max_test_id;
+
+#define FLAG_SET(map, i)    ((map)[(i) / 64] |= (1ULL << ((i) % 64)))
+#define FLAG_ISSET(map, i)  (((map)[(i) / 64] >> ((i) % 64)) & 1)
+
+#define SLOT_NONE 0xFFFFFFFF
+
+/* Dependency graph, built once by val_test_init. Each test keeps a bitmap of
+ * the slots it depends on, so a dependency check is a couple of mask
+ * operations against the pass bitmap instead of a scan of the test array.
+ */
+static test_flags g_dep_mask[SDEI_NUM_TESTS][SDEI_TEST_FLAG_WORDS];
+static uint32_t g_dep_broken[SDEI_NUM_TESTS];
+static uint32_t g_test_order[SDEI_NUM_TESTS];
+static test_flags g_test_passed[SDEI_TEST_FLAG_WORDS];
+static test_flags g_test_done[SDEI_TEST_FLAG_WORDS];
+
+/* Test slot to run on each PE in the current wave */
+static volatile uint32_t g_wave_slot[SDEI_MAX_PARALLEL_TESTS];
+
+/* Output of each wave test, replayed under its header when the wave is done */
+#define WAVE_LOG_ENTRIES 32
+
+typedef struct {
+    uint32_t verbosity;
+    char *fmt;
+    uint64_t args[VAL_PRINT_MAX_ARGS];
+} wave_log_entry;
+
+static wave_log_entry g_wave_log[SDEI_MAX_PARALLEL_TESTS][WAVE_LOG_ENTRIES];
+static volatile uint32_t g_wave_log_count[SDEI_MAX_PARALLEL_TESTS];
+static volatile uint32_t g_wave_active;
+
+static uint32_t test_slot(uint32_t test_id) {
+    uint32_t i;
+
+    if (g_test_slot_map)
+        return (test_id <= g_max_test_id) ? g_test_slot_map[test_id] : SLOT_NONE;
+
     for (i = 0; i < SDEI_NUM_TESTS && sdei_test[i].id != test_id; i++);
-    if (i < SDEI_NUM_TESTS)
-        return sdei_test[i].status == SDEI_TEST_PASS;
-    return 0;
+    return (i < SDEI_NUM_TESTS) ? i : SLOT_NONE;
+}
+
+static void build_test_slot_map(void) {
+    uint32_t i;
+
+    if (g_test_slot_map) {
+        pal_intf_free(g_test_slot_map);
+        g_test_slot_map = NULL;
+    }
+
+    g_max_test_id = 0;
+    for (i = 0; i < SDEI_NUM_TESTS; i++)
+        if (sdei_test[i].id > g_max_test_id)
+            g_max_test_id = sdei_test[i].id;
+
+    g_test_slot_map = pal_intf_alloc((g_max_test_id + 1) * sizeof(uint32_t));
+    if (g_test_slot_map == NULL) {
+        val_print(ACS_LOG_WARN, "\n        Test id map allocation failed");
+        return;
+    }
+    for (i = 0; i <= g_max_test_id; i++)
+        g_test_slot_map[i] = SLOT_NONE;
+    for (i = 0; i < SDEI_NUM_TESTS; i++) {
+        if (g_test_slot_map[sdei_test[i].id] != SLOT_NONE)
+            val_print(ACS_LOG_WARN, "\n        Test id %d registered twice", sdei_test[i].id);
+        else
+            g_test_slot_map[sdei_test[i].id] = i;
+    }
+}
+
+static void build_test_graph(void) {
+    uint32_t i, j, w, count, slot;
+    uint32_t pending[SDEI_NUM_TESTS];
+    sdei_test_deps *deps;
+
+    for (i = 0; i < SDEI_NUM_TESTS; i++) {
+        for (w = 0; w < SDEI_TEST_FLAG_WORDS; w++)
+            g_dep_mask[i][w] = 0;
+        g_dep_broken[i] = 0;
+        pending[i] = 0;
+        for (deps = sdei_test[i].deps; *deps != TEST_NONE_ID; deps++) {
+            slot = test_slot(*deps);
+            if (slot == SLOT_NONE) {
+                val_print(ACS_LOG_WARN, "\n        Test %d depends on unknown test %d",
+                                                                    sdei_test[i].id, *deps);
+                g_dep_broken[i] = 1;
+            } else if (!FLAG_ISSET(g_dep_mask[i], slot)) {
+                FLAG_SET(g_dep_mask[i], slot);
+                pending[i]++;
+            }
+        }
+    }
+
+    /* Topological order which keeps the published order wherever the
+     * dependencies allow it: always pick the lowest ready slot.
+     */
+    for (count = 0; count < SDEI_NUM_TESTS; count++) {
+        for (i = 0; i < SDEI_NUM_TESTS && pending[i] != 0; i++);
+        if (i == SDEI_NUM_TESTS)
+            break;
+        g_test_order[count] = i;
+        pending[i] = SLOT_NONE;
+        for (j = 0; j < SDEI_NUM_TESTS; j++)
+            if (pending[j] != SLOT_NONE && FLAG_ISSET(g_dep_mask[j], i))
+                pending[j]--;
+    }
+
+    /* Whatever is left is part of a dependency cycle and never runs */
+    for (i = 0; i < SDEI_NUM_TESTS && count < SDEI_NUM_TESTS; i++) {
+        if (pending[i] != SLOT_NONE) {
+            val_print(ACS_LOG_WARN, "\n        Test %d has cyclic dependencies",
+                                                                    sdei_test[i].id);
+            g_dep_broken[i] = 1;
+            g_test_order[count++] = i;
+        }
+    }
 }
 
-static int deps_resolved(sdei_test_deps *deps) {
-    int i;
-    for (i = 0; deps[i]!=0 && is_test_passed(deps[i]); i++);
-    return (deps[i] == 0);
+static int deps_resolved(uint32_t i) {
+    uint32_t w;
+    if (g_dep_broken[i])
+        return 0;
+    for (w = 0; w < SDEI_TEST_FLAG_WORDS; w++)
+        if (g_dep_mask[i][w] & ~g_test_passed[w])
+            return 0;
+    return 1;
 }
 
 static inline int run_test(sdei_test_control *control, int i) {
     if (control->flags[i/64] & (1ULL << (i % 64)))
-        return deps_resolved(sdei_test[i].deps);
+        return deps_resolved(i);
     return 0;
 }
 
@@ -50,27 +173,31 @@ static inline void disable_test(sdei_test_control *control, int i) {
 }
 
 void val_test_run_specific(sdei_test_control *control, int test_id, int init) {
-    int i;
+    uint32_t i;
     if (init) {
-        control->flags[0] = 0ULL;
-        control->flags[1] = 0ULL;
+        for (i = 0; i < SDEI_TEST_FLAG_WORDS; i++)
+            control->flags[i] = 0ULL;
     }
-    for (i = 0; i < SDEI_NUM_TESTS && sdei_test[i].id != test_id; i++);
-    if (i < SDEI_NUM_TESTS)
+    i = test_slot(test_id);
+    if (i != SLOT_NONE)
         enable_test(control, i);
 }
 
-static void init_test(sdei_test_control *control, sdei_test_desc *test) {
-    val_test_set_status(val_pe_get_num(), SDEI_TEST_PENDING);
+static void print_test_desc(sdei_test_desc *test) {
     /* Always print test id and test description */
     val_print(ACS_LOG_ERR, "\n%d. ", test->id);
 #ifdef TARGET_LINUX
-    val_print(ACS_LOG_ERR, "%s", test->description);
+    val_print(ACS_LOG_ERR, "%s", (uint64_t)test->description);
 #else
     val_print(ACS_LOG_ERR, test->description);
 #endif
 }
 
+static void init_test(sdei_test_control *control, sdei_test_desc *test) {
+    val_test_set_status(val_pe_get_num(), SDEI_TEST_PENDING);
+    print_test_desc(test);
+}
+
 static void log_test_result(sdei_test_control *control, int result) {
 
     /* Always print test results */
@@ -107,57 +234,14 @@ static void log_test_result(sdei_test_control *control, int result) {
  *  @return  none
  */
 void val_test_init(sdei_test_control *control) {
-    sdei_test[0] = test_001;
-    sdei_test[1] = test_002;
-    sdei_test[2] = test_003;
-    sdei_test[3] = test_004;
-    sdei_test[4] = test_005;
-    sdei_test[5] = test_006;
-    sdei_test[6] = test_007;
-    sdei_test[7] = test_008;
-    sdei_test[8] = test_009;
-    sdei_test[9] = test_010;
-    sdei_test[10] = test_011;
-    sdei_test[11] = test_012;
-    sdei_test[12] = test_013;
-    sdei_test[13] = test_014;
-    sdei_test[14] = test_015;
-    sdei_test[15] = test_016;
-    sdei_test[16] = test_017;
-    sdei_test[17] = test_018;
-    sdei_test[18] = test_019;
-    sdei_test[19] = test_020;
-    sdei_test[20] = test_021;
-    sdei_test[21] = test_022;
-    sdei_test[22] = test_023;
-    sdei_test[23] = test_024;
-    sdei_test[24] = test_025;
-    sdei_test[25] = test_026;
-    sdei_test[26] = test_027;
-    sdei_test[27] = test_028;
-    sdei_test[28] = test_029;
-    sdei_test[29] = test_030;
-    sdei_test[30] = test_031;
-    sdei_test[31] = test_032;
-    sdei_test[32] = test_033;
-    sdei_test[33] = test_034;
-    sdei_test[34] = test_035;
-    sdei_test[35] = test_036;
-    sdei_test[36] = test_037;
-    sdei_test[37] = test_038;
-    sdei_test[38] = test_039;
-    sdei_test[39] = test_040;
-    sdei_test[40] = test_041;
-    sdei_test[41] = test_042;
-    sdei_test[42] = test_043;
-    sdei_test[43] = test_044;
-    sdei_test[44] = test_045;
-    sdei_test[45] = test_046;
-    sdei_test[46] = test_047;
-    sdei_test[47] = test_048;
-    sdei_test[48] = test_049;
-    control->flags[0] = ~(0ULL);
-    control->flags[1] = ~(0ULL);
+    uint32_t i;
+
+    for (i = 0; i < SDEI_NUM_TESTS; i++)
+        sdei_test[i] = *g_test_list[i];
+    for (i = 0; i < SDEI_TEST_FLAG_WORDS; i++)
+        control->flags[i] = ~(0ULL);
+    build_test_slot_map();
+    build_test_graph();
 }
 
 /**
@@ -167,9 +251,8 @@ void val_test_init(sdei_test_control *control) {
  *  @return  none
  */
 void val_test_enable(sdei_test_control *control, int test_id) {
-    int i;
-    for (i = 0; i < SDEI_NUM_TESTS && sdei_test[i].id != test_id; i++);
-    if (i < SDEI_NUM_TESTS)
+    uint32_t i = test_slot(test_id);
+    if (i != SLOT_NONE)
         enable_test(control, i);
 }
 
@@ -180,34 +263,193 @@ void val_test_enable(sdei_test_control *control, int test_id) {
  *  @return  none
  */
 void val_test_disable(sdei_test_control *control, int test_id) {
-    int i;
-    for (i = 0; i < SDEI_NUM_TESTS && sdei_test[i].id != test_id; i++);
-    if (i < SDEI_NUM_TESTS)
+    uint32_t i = test_slot(test_id);
+    if (i != SLOT_NONE)
         disable_test(control, i);
 }
 
+static void finish_test(sdei_test_control *control, uint32_t i, uint32_t status) {
+    sdei_test[i].status = status;
+    FLAG_SET(g_test_done, i);
+    if (status == SDEI_TEST_PASS)
+        FLAG_SET(g_test_passed, i);
+    log_test_result(control, status);
+}
+
+static int wave_capable(uint32_t i) {
+    return !sdei_test[i].all_pe && sdei_test[i].resources != SDEI_RES_EXCLUSIVE;
+}
+
 /**
- *  @brief   This function executes all test cases and log the results
+ *  @brief   Collect ready tests, starting at position pos of the run order, that can
+ *           share the system with the given test. Returns the number of wave entries.
+ */
+static uint32_t build_wave(sdei_test_control *control, uint32_t first, uint32_t pos,
+                           uint32_t *wave, uint32_t max)
+{
+    uint32_t count = 1, used, i;
+
+    wave[0] = first;
+    if (!wave_capable(first))
+        return count;
+
+    used = sdei_test[first].resources;
+    for (; pos < SDEI_NUM_TESTS && count < max; pos++) {
+        i = g_test_order[pos];
+        if (FLAG_ISSET(g_test_done, i) || !wave_capable(i) || !run_test(control, i))
+            continue;
+        if (sdei_test[i].resources & used)
+            continue;
+        used |= sdei_test[i].resources;
+        wave[count++] = i;
+    }
+    return count;
+}
+
+static void wave_payload(void)
+{
+    uint32_t index = val_pe_get_index();
+    uint32_t slot;
+
+    if (index >= SDEI_MAX_PARALLEL_TESTS)
+        return;
+    slot = g_wave_slot[index];
+    if (slot != SLOT_NONE)
+        sdei_test[slot].test_fn();
+}
+
+/**
+ *  @brief   Hold back a message printed by a PE that runs a wave test.
+ *  @param verbosity  print level
+ *  @param fmt        format string
+ *  @param args       format arguments
+ *  @param num_args   number of format arguments
+ *
+ *  @return  1 if the message was held back, 0 if it has to be printed now
+ */
+uint32_t val_print_defer(uint32_t verbosity, char *fmt, uint64_t *args, uint32_t num_args)
+{
+    wave_log_entry *entry;
+    uint32_t index, i;
+
+    if (!g_wave_active)
+        return 0;
+
+    index = val_pe_get_index();
+    if (index >= SDEI_MAX_PARALLEL_TESTS || g_wave_slot[index] == SLOT_NONE)
+        return 0;
+
+    /* Keep counting once the log is full, so the loss is reported */
+    i = g_wave_log_count[index]++;
+    if (i >= WAVE_LOG_ENTRIES)
+        return 1;
+
+    entry = &g_wave_log[index][i];
+    entry->verbosity = verbosity;
+    entry->fmt = fmt;
+    for (i = 0; i < VAL_PRINT_MAX_ARGS; i++)
+        entry->args[i] = (i < num_args) ? args[i] : 0;
+    return 1;
+}
+
+static void print_wave_log(uint32_t index)
+{
+    wave_log_entry *entry;
+    uint32_t i, count;
+
+    count = g_wave_log_count[index];
+    for (i = 0; i < count && i < WAVE_LOG_ENTRIES; i++) {
+        entry = &g_wave_log[index][i];
+        pal_print(entry->verbosity, entry->fmt, entry->args[0], entry->args[1],
+                  entry->args[2], entry->args[3]);
+    }
+    if (count > WAVE_LOG_ENTRIES)
+        pal_print(ACS_LOG_WARN, "\n        %d messages dropped", count - WAVE_LOG_ENTRIES);
+}
+
+static uint32_t wait_pe_status(uint32_t index, uint64_t timeout)
+{
+    uint32_t status;
+
+    while (timeout--) {
+        status = val_test_pe_get_status(index);
+        if (status != SDEI_TEST_PENDING)
+            return status;
+    }
+    return SDEI_TEST_TIMEOUT;
+}
+
+static void run_wave(sdei_test_control *control, uint32_t *wave, uint32_t count)
+{
+    uint32_t i;
+    uint32_t status[SDEI_MAX_PARALLEL_TESTS];
+
+    for (i = 0; i < SDEI_MAX_PARALLEL_TESTS; i++) {
+        g_wave_slot[i] = (i < count) ? wave[i] : SLOT_NONE;
+        g_wave_log_count[i] = 0;
+        val_pe_data_cache_clean_invalidate((uint64_t)&g_wave_slot[i]);
+    }
+    val_test_set_status(val_pe_get_num(), SDEI_TEST_PENDING);
+
+    g_wave_active = 1;
+    val_pe_execute_on_all_concurrent((void *)wave_payload, 0);
+
+    for (i = 0; i < count; i++)
+        status[i] = wait_pe_status(i, TEST_TIMEOUT);
+    g_wave_active = 0;
+
+    /* Each test is reported with its own output, in dispatch order */
+    for (i = 0; i < count; i++) {
+        print_test_desc(&sdei_test[wave[i]]);
+        print_wave_log(i);
+        finish_test(control, wave[i], status[i]);
+    }
+}
+
+/**
+ *  @brief   This function executes all test cases and log the results.
+ *           Tests run in dependency order. Ready tests with disjoint resource
+ *           declarations are grouped into waves and run on different PEs at
+ *           the same time.
  *
  *  @return  none
  */
 void val_test_execute(sdei_test_control *control) {
-    int i;
+    uint32_t pos, i, count, max;
     uint32_t num_pe;
+    uint32_t wave[SDEI_MAX_PARALLEL_TESTS];
+
+    for (i = 0; i < SDEI_TEST_FLAG_WORDS; i++)
+        g_test_passed[i] = g_test_done[i] = 0;
+
+    max = val_pe_get_num();
+    if (max > SDEI_MAX_PARALLEL_TESTS)
+        max = SDEI_MAX_PARALLEL_TESTS;
+
+    for (pos = 0; pos < SDEI_NUM_TESTS; pos++) {
+        i = g_test_order[pos];
+        if (FLAG_ISSET(g_test_done, i))
+            continue;
+
+        if (!run_test(control, i)) {
+            print_test_desc(&sdei_test[i]);
+            finish_test(control, i, SDEI_TEST_SKIP);
+            continue;
+        }
+
+        count = build_wave(control, i, pos + 1, wave, max);
+        if (count > 1) {
+            run_wave(control, wave, count);
+            continue;
+        }
 
-    for (i = 0; i < SDEI_NUM_TESTS; i++) {
         init_test(control, &sdei_test[i]);
         if (sdei_test[i].all_pe)
             num_pe = val_pe_get_num();
         else
             num_pe = 1;
-        if (run_test(control, i)) {
-            sdei_test[i].test_fn();
-            sdei_test[i].status = val_test_get_status(num_pe, TEST_TIMEOUT);
-        }
-        else
-            sdei_test[i].status = SDEI_TEST_SKIP;
-        log_test_result(control, sdei_test[i].status);
+        sdei_test[i].test_fn();
+        finish_test(control, i, val_test_get_status(num_pe, TEST_TIMEOUT));
     }
 }
 